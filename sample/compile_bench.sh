@@ -0,0 +1,73 @@
+#!/bin/sh
+# Compares the build time of a suite of N generated test files, in the header-only layout
+# (each file includes test.h) and in the separate layout (each file includes test_decl.h, test.cpp is compiled once).
+# usage : compile_bench.sh [N] [compiler flags...]   (default : 50 files, -O0)
+N=${1:-50}
+[ $# -gt 0 ] && shift
+FLAGS=${*:--O0}
+CXX=${CXX:-g++}
+JOBS=$(nproc 2>/dev/null || echo 1)
+ROOT=$(cd "$(dirname "$0")/.." && pwd)
+WORK=$(mktemp -d)
+trap 'rm -rf "$WORK"' EXIT
+
+generate() # layout header
+{
+	mkdir -p "$WORK/$1"
+	i=0
+	while [ $i -lt $N ]; do
+		cat > "$WORK/$1/test$i.cpp" <<EOF
+#include "$ROOT/$2"
+namespace {
+	class Test$i : public tests::Test
+	{
+		protected:
+			void test_code(){
+				std::vector<int> values;
+				for(int k=0;k<$i+20;k++) values.push_back(k*k);
+				assert_equal(100, values[10], "square");
+				assert_equal(std::string("test$i"), std::string("test")+std::to_string($i), "name");
+				assert_equal(0.5*$i, $i/2.0, 1e-9, "half");
+				assert_true(!values.empty(), "not empty");
+				assert_collection_equals(values.cbegin(), values.cend(), values.cbegin(), values.cend(), "same");
+				assert_contains(values.begin(), values.end(), 81, "contains");
+			}
+	};
+}
+tests::Test* make_test$i() { return new Test$i; }
+EOF
+		i=$((i+1))
+	done
+	{
+		echo "#include \"$ROOT/test.h\""
+		i=0
+		while [ $i -lt $N ]; do echo "tests::Test* make_test$i();"; i=$((i+1)); done
+		echo "int main(){"
+		echo "	tests::Suite suite;"
+		echo "	std::vector<std::unique_ptr<tests::Test>> all;"
+		i=0
+		while [ $i -lt $N ]; do echo "	all.emplace_back(make_test$i()); suite.add(*all.back());"; i=$((i+1)); done
+		echo "	return suite.run()==0 ? 0 : 1;"
+		echo "}"
+	} > "$WORK/$1/main.cpp"
+}
+
+build() # layout defines...
+{
+	layout=$1
+	shift
+	start=$(date +%s.%N)
+	ls "$WORK/$layout"/*.cpp | xargs -P "$JOBS" -I{} sh -c "$CXX -std=c++11 $FLAGS $* -pthread -c {} -o {}.o" || exit 1
+	$CXX -pthread "$WORK/$layout"/*.o -o "$WORK/$layout/suite" || exit 1
+	end=$(date +%s.%N)
+	"$WORK/$layout/suite" > "$WORK/$layout/log" || { grep failed "$WORK/$layout/log"; echo "the $layout suite failed"; exit 1; }
+	awk -v layout="$layout" -v start="$start" -v end="$end" 'BEGIN { printf "%s : %.2f s\n", layout, end-start }'
+}
+
+generate header test.h
+generate separate test_decl.h
+cp "$ROOT/test.cpp" "$WORK/separate/implementation.cpp"
+sed -i "s|\"test.h\"|\"$ROOT/test.h\"|" "$WORK/separate/implementation.cpp"
+echo "$N test files, $CXX $FLAGS, $JOBS jobs :"
+build header
+build separate -DTESTS_SEPARATE_COMPILATION
@@ -12,29 +12,27 @@ class DivideByZero{};
 */
 class Ratio
 {
-    int num;
-    int den;
+    long long num;
+    long long den;
 
  public:
  /**
-  * Initialize the ratio
+  * Initialize the ratio (at compile time when n and d are constants)
   * @param n the numerator
   * @param d the denominator (must not be null)
   * @throws DivideByZero if denominator is null
  */
-    Ratio(int n=0, int d=1):num(n),den(d){
-        if(d==0) throw DivideByZero();
-    }
+    constexpr Ratio(long long n=0, long long d=1):num(n),den(d==0 ? throw DivideByZero() : d){}
 
     /**
      * Converts to float value
      * @return the value 
     */
-    double to_double() const {return (double)num/(double)den;}    
-    int numerator() const {return num;}
-    int denominator() const {return den;}
+    constexpr double to_double() const {return (double)num/(double)den;}
+    constexpr long long numerator() const {return num;}
+    constexpr long long denominator() const {return den;}
     /**
-     * Add a ratio
+     * Add a ratio (the products are computed in long long : sums of ratios of ints do not overflow)
      * @param r the other ratio to add
     */
     void operator+=(const Ratio& r)
@@ -45,10 +43,10 @@ class Ratio
     /**
      * Ratio comparison
     */
-    bool operator==(const Ratio& other) const{
+    constexpr bool operator==(const Ratio& other) const{
         return num*other.den == other.num*den;
     }
-    bool operator!=(const Ratio& other) const{
+    constexpr bool operator!=(const Ratio& other) const{
         return !operator==(other);
     }
 };
@@ -59,11 +57,9 @@ class Ratio
  * @param r2 the second ratio
  * @return r1+r2
 */
-Ratio operator+(const Ratio& r1, const Ratio& r2)
+constexpr Ratio operator+(const Ratio& r1, const Ratio& r2)
 {
-    Ratio r(r1);
-    r+=r2;
-    return r;
+    return Ratio(r1.numerator()*r2.denominator()+r2.numerator()*r1.denominator(), r1.denominator()*r2.denominator());
 }
 
 /**
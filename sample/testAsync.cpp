@@ -0,0 +1,197 @@
+// coroutine tests : build with -std=c++20 on Linux.
+// co_await is kept out of conditions and arguments : g++ 12 does not run a coroutine which awaits in the condition of an if
+#include "test.h"
+#include <fcntl.h>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <vector>
+
+using namespace tests;
+using namespace std::chrono_literals;
+
+/**
+ * Reads a byte when the file descriptor is ready : '?' when it is not, or when there is nothing to read
+*/
+static Task<> read_byte(int fd, std::string& read)
+{
+    bool ready = co_await readable(fd, 1000ms);
+    char c;
+    read += ready && ::read(fd, &c, 1)==1 ? c : '?';
+}
+
+/**
+ * Writes a text, after a delay
+*/
+static Task<> write_later(int fd, std::string text, std::chrono::milliseconds delay)
+{
+    co_await sleep_for(delay);
+    bool ready = co_await writable(fd, 1000ms);
+    if(ready) (void)!::write(fd, text.data(), text.size());
+}
+
+/**
+ * Answers "pong" to the first message of a socket
+*/
+static Task<> answer(int fd)
+{
+    char buffer[16];
+    bool ready = co_await readable(fd, 1000ms);
+    if(!ready || ::read(fd, buffer, sizeof(buffer))<=0) co_return;
+    ready = co_await writable(fd, 1000ms);
+    if(ready) (void)!::write(fd, "pong", 4);
+}
+
+static Task<> pause(std::chrono::milliseconds duration)
+{
+    co_await sleep_for(duration);
+}
+
+static Task<int> twice(int value)
+{
+    co_await sleep_for(1ms);
+    co_return 2*value;
+}
+
+static Task<> fail_later()
+{
+    co_await sleep_for(1ms);
+    throw std::runtime_error("failed task");
+}
+
+/**
+ * The waits of a coroutine test : deadlines, file descriptors, tasks
+*/
+class TestWaits : public AsyncTest
+{
+    protected:
+        Task<> co_test_code() override{
+            std::uint64_t start = EventLoop::now();
+            co_await sleep_for(20ms);
+            assert_true(EventLoop::now()-start>=20000000, "sleep_for");
+            int result = co_await twice(21);
+            assert_equal(42, result, "result of a task");
+
+            int pipe[2];
+            assert_equal(0, pipe2(pipe, O_NONBLOCK), "pipe");
+            bool ready = co_await readable(pipe[0], 10ms);
+            assert_false(ready, "readable times out");
+
+            // two readers of one pipe : each byte resumes one of them, the other one keeps waiting
+            std::string read;
+            std::vector<Task<>> tasks;
+            tasks.push_back(read_byte(pipe[0], read));
+            tasks.push_back(read_byte(pipe[0], read));
+            tasks.push_back(write_later(pipe[1], "a", 10ms));
+            tasks.push_back(write_later(pipe[1], "b", 30ms));
+            co_await when_all(std::move(tasks));
+            assert_equal(std::string("ab"), read, "two readers of one file descriptor");
+            close(pipe[0]);
+            close(pipe[1]);
+
+            // a reader and a writer of one socket, and the other end which answers
+            int sockets[2];
+            assert_equal(0, socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0, sockets), "socketpair");
+            std::string answered;
+            tasks.clear();
+            tasks.push_back(answer(sockets[1]));
+            tasks.push_back(read_byte(sockets[0], answered));
+            tasks.push_back(write_later(sockets[0], "ping", 10ms));
+            co_await when_all(std::move(tasks));
+            assert_equal(std::string("p"), answered, "a reader and a writer of one file descriptor");
+            close(sockets[0]);
+            close(sockets[1]);
+
+            // regular files are always ready, and a closed file descriptor can't be waited for
+            FILE* file = std::tmpfile();
+            ready = co_await readable(fileno(file), 10ms);
+            assert_true(ready, "regular file");
+            int closed = dup(fileno(file));
+            std::fclose(file);
+            close(closed);
+            bool thrown = false;
+            try{
+                co_await readable(closed, 10ms);
+            }
+            catch(const std::runtime_error&){
+                thrown = true;
+            }
+            assert_true(thrown, "closed file descriptor");
+
+            // when_all throws the exception of a task, after all the tasks end
+            tasks.clear();
+            tasks.push_back(fail_later());
+            tasks.push_back(pause(20ms));
+            std::string message;
+            start = EventLoop::now();
+            try{
+                co_await when_all(std::move(tasks));
+            }
+            catch(const std::runtime_error& exception){
+                message = exception.what();
+            }
+            assert_equal(std::string("failed task"), message, "exception of a task");
+            assert_true(EventLoop::now()-start>=20000000, "all the tasks end");
+        }
+};
+
+/**
+ * A test which waits : run_all runs many of them on one thread
+*/
+class Sleeper : public AsyncTest
+{
+    private:
+        std::chrono::milliseconds duration;
+    public:
+        Sleeper(std::ostream& output, unsigned long timeout, std::chrono::milliseconds duration)
+            : AsyncTest(output, timeout), duration(duration){}
+        std::string name() const override { return "Sleeper"; }
+    protected:
+        Task<> co_test_code() override{
+            co_await sleep_for(duration);
+            assert_true(true, "awake");
+        }
+};
+
+/**
+ * The waits of many tests overlap, and the timeout of a test bounds its waits
+*/
+class TestRunAll : public Test
+{
+    protected:
+        void test_code() override{
+            std::ostringstream output;
+            std::vector<std::unique_ptr<Sleeper>> sleepers;
+            std::vector<AsyncTest*> tests;
+            for(int i=0;i<50;i++){
+                sleepers.emplace_back(new Sleeper(output, 1000, 20ms));
+                tests.push_back(sleepers.back().get());
+            }
+            Chrono chrono;
+            chrono.start();
+            assert_equal(0, AsyncTest::run_all(tests), "50 tests");
+            chrono.stop();
+            assert_true(chrono.time()<500, "waits overlap : 50 waits of 20 ms");
+
+            std::ostringstream late;
+            Sleeper slow(late, 50, 10s), fast(late, 1000, 1ms);
+            chrono.start();
+            assert_equal(1, AsyncTest::run_all({ &slow, &fast }), "one test times out");
+            chrono.stop();
+            assert_true(chrono.time()<1000, "the timeout bounds the wait");
+            assert_true(late.str().find("*** timeout ***")!=std::string::npos, "timeout reported");
+            assert_equal(1, fast.passed_count(), "other test");
+        }
+};
+
+int main()
+{
+    Suite suite;
+    TestWaits waits;
+    TestRunAll run_all;
+    suite.add(waits);
+    suite.add(run_all);
+    return suite.run()==0 ? 0 : 1;
+}
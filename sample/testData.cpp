@@ -0,0 +1,206 @@
+#include "test.h"
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <sys/resource.h>
+
+using namespace tests;
+
+/**
+ * Writes a data file of the sample
+*/
+static void write_file(const std::string& path, const std::string& content)
+{
+    std::ofstream file(path.c_str(), std::ios::binary);
+    file.write(content.data(), content.size());
+}
+
+/**
+ * Writes a binary file of (id, value) records : 12 bytes each, without padding
+*/
+static void write_records(const std::string& path, std::uint32_t count, std::uint32_t wrong)
+{
+    std::string content;
+    content.reserve(count*12);
+    for(std::uint32_t id=0;id<count;id++){
+        double value = id==wrong ? -1.0 : id*0.5;
+        content.append(reinterpret_cast<const char*>(&id), sizeof(id));
+        content.append(reinterpret_cast<const char*>(&value), sizeof(value));
+    }
+    write_file(path, content);
+}
+
+/**
+ * Writes a CSV file of "id,value" lines, bigger than a chunk (4 MB) : its records span several chunks
+*/
+static void write_lines(const std::string& path, std::uint32_t count, std::uint32_t wrong)
+{
+    std::ofstream file(path.c_str(), std::ios::binary);
+    file << "id,value\n";
+    char line[64];
+    for(std::uint32_t id=0;id<count;id++){
+        int length = std::snprintf(line, sizeof(line), "%u,%.1f\n", id, id==wrong ? -1.0 : id*0.5);
+        file.write(line, length);
+    }
+}
+
+/**
+ * Checks the records of CSV files : header, comments, empty lines, quotes, and the records which span chunks
+*/
+class TestCsv : public Test
+{
+    protected:
+        void set_up() override{
+            write_file("testData_people.csv",
+                "id,name,age\r\n"
+                "# comments and empty lines are ignored\r\n"
+                "1,\"Smith, John\",42\r\n"
+                "\r\n"
+                "2, Doe ,7\r\n"
+                "3,\"She said \"\"hi\"\", twice\",30\r\n"
+                "4,\"\",0");
+            write_lines("testData_big.csv", 400000, 400000);
+        }
+        void tear_down() override{
+            std::remove("testData_people.csv");
+            std::remove("testData_big.csv");
+        }
+        void test_code() override{
+            int count = 0;
+            std::string names;
+            set_data_threads(1); // the hook fills names in order
+            for_each_csv<int, Text, int>("testData_people.csv", [&](int id, const Text& name, int age){
+                count++;
+                names += name.str()+"|";
+                return id>0 && age>=0;
+            }, "header skipped, comments and empty lines ignored", true);
+            assert_equal(4, count, "every record checked");
+            assert_equal(std::string("Smith, John|Doe|She said \"\"hi\"\", twice||"), names, "quoted commas and spaces");
+
+            set_data_threads(0);
+            std::atomic<std::uint64_t> records(0), sum(0);
+            for_each_csv<std::uint32_t, double>("testData_big.csv", [&](std::uint32_t id, double value){
+                records++;
+                sum += id;
+                return value==id*0.5;
+            }, "records spanning chunks", true);
+            assert_equal((std::uint64_t)400000, records.load(), "each record checked once");
+            assert_equal((std::uint64_t)400000*399999/2, sum.load(), "no record lost between chunks");
+        }
+};
+
+/**
+ * Checks the records of a binary file bigger than a chunk
+*/
+class TestBinary : public Test
+{
+    protected:
+        void set_up() override{ write_records("testData_values.bin", 500000, 500000); }
+        void tear_down() override{ std::remove("testData_values.bin"); }
+        void test_code() override{
+            std::atomic<std::uint64_t> records(0), sum(0);
+            for_each_binary<std::uint32_t, double>("testData_values.bin", [&](std::uint32_t id, double value){
+                records++;
+                sum += id;
+                return value==id*0.5;
+            }, "records of 12 bytes");
+            assert_equal((std::uint64_t)500000, records.load(), "each record checked once");
+            assert_equal((std::uint64_t)500000*499999/2, sum.load(), "no record lost between chunks");
+        }
+};
+
+/**
+ * Wrong files : each assertion fails, its message is checked by TestMessages
+*/
+class WrongFiles : public Test
+{
+    public:
+        explicit WrongFiles(std::ostream& output) : Test(output){}
+    protected:
+        void test_code() override{
+            auto positive = [](int id, double value){ return id>=0 && value>=0; };
+            for_each_csv<int, double>("testData_header.csv", positive, "header not skipped");
+            for_each_csv<int, double>("testData_fields.csv", positive, "too many fields");
+            for_each_csv<int, double>("testData_wrong.csv", positive, "wrong record");
+            for_each_csv<int, double>("testData_missing.csv", positive, "missing file");
+            // the wrong records are in the second chunk of 4 MB
+            for_each_csv<std::uint32_t, double>("testData_late.csv", [](std::uint32_t, double value){ return value>=0; }, "late record", true);
+            for_each_binary<std::uint32_t, double>("testData_late.bin", [](std::uint32_t, double value){ return value>=0; }, "late binary record");
+            for_each_binary<std::uint32_t, double>("testData_cut.bin", [](std::uint32_t, double){ return true; }, "cut binary file");
+        }
+};
+
+/**
+ * Checks the messages of the wrong files : they tell the line, the field and the record
+*/
+class TestMessages : public Test
+{
+    private:
+        std::string output;
+        void assert_output(const char* message, Name name){
+            assert_true(output.find(message)!=std::string::npos, name);
+        }
+    protected:
+        void set_up() override{
+            write_file("testData_header.csv", "id,value\n1,2.5\n");
+            write_file("testData_fields.csv", "1,2.5\n2,3.5,extra\n");
+            write_file("testData_wrong.csv", "# id, value\n1,2.5\n\n2,-3.5\n");
+            write_lines("testData_late.csv", 400000, 399000);
+            write_records("testData_late.bin", 500000, 450000);
+            write_file("testData_cut.bin", std::string(13, '\0'));
+        }
+        void tear_down() override{
+            const char* const files[] = { "testData_header.csv", "testData_fields.csv", "testData_wrong.csv",
+                "testData_late.csv", "testData_late.bin", "testData_cut.bin" };
+            for(const char* file : files) std::remove(file);
+        }
+        void test_code() override{
+            std::ostringstream text;
+            StreamReporter reporter(text);
+            WrongFiles wrong(text);
+            wrong.set_reporter(&reporter);
+            wrong.run();
+            output = text.str();
+            assert_equal(7, wrong.failed_count(), "every wrong file fails");
+            assert_output("record at line 1 of testData_header.csv : the field 1 can't be parsed.", "header");
+            assert_output("record at line 2 of testData_fields.csv : more than 2 fields.", "fields");
+            assert_output("record at line 4 of testData_wrong.csv is wrong.", "wrong record");
+            assert_output("record : 2,-3.5", "wrong record shown");
+            assert_output("the file testData_missing.csv can't be read.", "missing file");
+            assert_output("record at line 399002 of testData_late.csv is wrong.", "first wrong record of the second chunk");
+            assert_output("record 450000 (at byte 5400000) of testData_late.bin is wrong.", "first wrong binary record");
+            assert_output("the size of testData_cut.bin is not a multiple of the size of a record (12 bytes).", "cut binary file");
+        }
+};
+
+int main(int argc, char* argv[])
+{
+    if(argc>1 && std::strcmp(argv[1], "big")==0){
+        // a big file of 20 million records (367 MB) : its memory stays flat, see the maximum RSS of the process
+        class TestBig : public Test
+        {
+            protected:
+                void test_code() override{
+                    for_each_csv<std::uint32_t, double>("testData_big.csv", [](std::uint32_t id, double value){ return value==id*0.5; }, "big file", true);
+                }
+        };
+        write_lines("testData_big.csv", 20000000, 20000000);
+        TestBig big;
+        big.run();
+        std::remove("testData_big.csv");
+        struct rusage usage;
+        getrusage(RUSAGE_SELF, &usage);
+        std::cout << "Maximum RSS is " << usage.ru_maxrss << " KB.\r\n";
+        return big.failed_count()==0 ? 0 : 1;
+    }
+    Suite suite;
+    TestCsv csv;
+    TestBinary binary;
+    TestMessages messages;
+    suite.add(csv);
+    suite.add(binary);
+    suite.add(messages);
+    return suite.run()==0 ? 0 : 1;
+}
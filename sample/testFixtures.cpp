@@ -0,0 +1,143 @@
+#include "test.h"
+#include <algorithm>
+#include <stdexcept>
+#include <vector>
+
+using namespace tests;
+
+/**
+ * The prime numbers below a bound, long enough to compute to be shared by the tests
+*/
+class Primes
+{
+    private:
+        std::vector<int> values;
+    public:
+        explicit Primes(int bound){
+            std::vector<bool> composite(bound, false);
+            for(int i=2;i<bound;i++){
+                if(composite[i]) continue;
+                values.push_back(i);
+                for(long long j=(long long)i*i;j<bound;j+=i) composite[(std::size_t)j] = true;
+            }
+        }
+        bool contains(int n) const { return std::binary_search(values.begin(), values.end(), n); }
+        std::size_t size() const { return values.size(); }
+};
+
+/**
+ * A value whose build always fails
+*/
+struct Unreachable
+{
+    Unreachable(){ throw std::runtime_error("the server is unreachable"); }
+};
+
+static SharedFixture<Primes> primes([]{ return new Primes(1000000); });
+static SharedFixture<Unreachable> server;
+
+/**
+ * Reads the shared primes, and keeps its own state in the arena of the test
+*/
+class TestPrimes : public Test
+{
+    private:
+        int from;
+        std::vector<int, ArenaAllocator<int>>* found;
+    protected:
+        void set_up() override{
+            // destroyed with the arena when the test ends
+            found = arena().make<std::vector<int, ArenaAllocator<int>>>(ArenaAllocator<int>(arena()));
+        }
+        void test_code() override{
+            assert_equal((std::size_t)78498, primes->size(), "primes below one million");
+            for(int n=from;n<from+1000;n++)
+                if(primes->contains(n)) found->push_back(n);
+            assert_false(found->empty(), "primes in the range");
+            assert_true(std::all_of(found->begin(), found->end(), [](int n){ return n%2!=0 || n==2; }), "odd primes");
+        }
+        void tear_down() override{
+            assert_true(arena().capacity()>0, "state allocated in the arena");
+        }
+    public:
+        explicit TestPrimes(int from):from(from){ uses(primes); }
+};
+
+/**
+ * A test whose fixture can't be built sees the exception of its factory
+*/
+class TestServer : public Test
+{
+    protected:
+        void test_code() override{
+            assert_throws<std::runtime_error>([](){ *server; }, "a fixture whose build fails throws");
+            assert_false(server.ready(), "the failed fixture is built again by its next reader");
+        }
+    public:
+        TestServer(){ uses(server); }
+};
+
+/**
+ * set_up and tear_down surround the code of the test, even when it throws
+*/
+class TestSteps : public Test
+{
+    private:
+        std::vector<std::string> steps;
+    protected:
+        void set_up() override{ steps.push_back("set_up"); }
+        void test_code() override{
+            steps.push_back("test_code");
+            assert_equal((std::size_t)2, steps.size(), "set_up first");
+        }
+        void tear_down() override{
+            steps.push_back("tear_down");
+            assert_equal(std::string("test_code"), steps[1], "tear_down last");
+        }
+};
+
+/**
+ * Objects made in an arena are destroyed by its reset, in reverse order
+*/
+class TestArena : public Test
+{
+    private:
+        struct Counted
+        {
+            std::vector<int>& destroyed;
+            int id;
+            Counted(std::vector<int>& destroyed, int id):destroyed(destroyed),id(id){}
+            ~Counted(){ destroyed.push_back(id); }
+        };
+    protected:
+        void test_code() override{
+            Arena local(256);
+            std::vector<int> destroyed;
+            for(int i=0;i<3;i++) local.make<Counted>(destroyed, i);
+            int* numbers = static_cast<int*>(local.allocate(1000*sizeof(int), alignof(int)));
+            numbers[999] = 7;
+            assert_true(local.capacity()>=1000*sizeof(int), "blocks grow with the allocations");
+            std::size_t capacity = local.capacity();
+            local.reset();
+            std::vector<int> reverse = {2, 1, 0};
+            assert_collection_equals(destroyed.begin(), destroyed.end(), reverse.begin(), reverse.end(), "destroyed in reverse order");
+            local.make<Counted>(destroyed, 3);
+            assert_equal(capacity, local.capacity(), "blocks kept by reset");
+            local.reset();
+            assert_equal(4, (int)destroyed.size(), "destroyed once");
+        }
+};
+
+int main()
+{
+    Suite suite;
+    for(int from : {0, 100000, 500000, 900000})
+        suite.add(std::unique_ptr<Test>(new TestPrimes(from)));
+    TestServer server_test;
+    TestSteps steps;
+    TestArena arena;
+    suite.add(server_test);
+    suite.add(steps);
+    suite.add(arena);
+    return suite.run()==0 ? 0 : 1;
+}
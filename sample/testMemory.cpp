@@ -0,0 +1,133 @@
+// counts the heap allocations of the program : defined in one file only, before including test.h
+#define TESTS_COUNT_ALLOCATIONS
+#include "test.h"
+#include <new>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace tests;
+
+#if defined(__cpp_aligned_new)
+/**
+ * A type aligned beyond the default alignment of new
+*/
+struct alignas(64) Line
+{
+    char bytes[64];
+};
+#endif
+
+/**
+ * Checks that every form of the operators new and delete is counted, built with TESTS_COUNT_ALLOCATIONS
+ * (build with -std=c++17 to check the aligned forms too)
+*/
+class TestOperators : public Test
+{
+    private:
+        AllocationCounters before;
+        void start(){ before = allocation_counters(); }
+        // checks the allocations since start() : their number and bytes, and that they were all freed
+        // (the assertions allocate for their messages, so none runs between start() and check())
+        void check(std::uint64_t count, std::uint64_t bytes, Name name){
+            const AllocationCounters& now = allocation_counters();
+            assert_equal(count, now.count-before.count, name);
+            assert_true(now.bytes-before.bytes>=bytes, name);
+            assert_equal((std::int64_t)0, now.live-before.live, name);
+        }
+    protected:
+        void test_code() override{
+            assert_true(allocations_counted(), "allocations are counted");
+
+            start();
+            int* one = new int(1);
+            delete one;
+            check(1, sizeof(int), "new and delete");
+
+            start();
+            int* many = new int[100];
+            delete[] many;
+            check(1, 100*sizeof(int), "new[] and delete[]");
+
+            start();
+            int* maybe = new(std::nothrow) int(2);
+            bool allocated = maybe!=nullptr;
+            delete maybe;
+            int* maybe_many = new(std::nothrow) int[10];
+            delete[] maybe_many;
+            void* raw = ::operator new(32, std::nothrow);
+            ::operator delete(raw, std::nothrow);
+            void* raw_many = ::operator new[](32, std::nothrow);
+            ::operator delete[](raw_many, std::nothrow);
+            check(4, 2*32+sizeof(int)*11, "nothrow forms");
+            assert_true(allocated, "nothrow new");
+
+#if defined(__cpp_sized_deallocation)
+            start();
+            void* sized = ::operator new(48);
+            ::operator delete(sized, 48);
+            void* sized_many = ::operator new[](48);
+            ::operator delete[](sized_many, 48);
+            check(2, 96, "sized delete");
+#endif
+#if defined(__cpp_aligned_new)
+            start();
+            Line* line = new Line();
+            std::uintptr_t misaligned = reinterpret_cast<std::uintptr_t>(line)%64;
+            delete line;
+            Line* lines = new Line[3];
+            misaligned |= reinterpret_cast<std::uintptr_t>(lines)%64;
+            delete[] lines;
+            Line* maybe_line = new(std::nothrow) Line();
+            delete maybe_line;
+            void* aligned = ::operator new(100, std::align_val_t(128));
+            misaligned |= reinterpret_cast<std::uintptr_t>(aligned)%128;
+            ::operator delete(aligned, 100, std::align_val_t(128));
+            void* aligned_many = ::operator new[](100, std::align_val_t(128), std::nothrow);
+            ::operator delete[](aligned_many, std::align_val_t(128), std::nothrow);
+            check(5, 5*64+200, "aligned forms");
+            assert_equal((std::uintptr_t)0, misaligned, "aligned addresses");
+#endif
+            // only the allocations of the thread of the test are counted
+            start();
+            std::thread other([](){ delete new std::vector<int>(1000); });
+            std::uint64_t count = allocation_counters().count;
+            other.join();
+            assert_true(allocation_counters().count-count<=1, "allocations of other threads are not counted");
+        }
+};
+
+/**
+ * The memory assertions on the code of a test
+*/
+class TestAssertions : public Test
+{
+    protected:
+        void test_code() override{
+            std::vector<int> values;
+            values.reserve(1000);
+            assert_no_alloc([&](){
+                for(int i=0;i<1000;i++) values.push_back(i);
+            }, "push_back within the capacity");
+            assert_max_allocations(1, [](){
+                std::string text(100, 'x');
+                do_not_optimize(text);
+            }, "one allocation for a long string");
+            assert_peak_memory_below(8192, [](){
+                for(int i=0;i<100;i++){
+                    std::vector<char> buffer(4096);
+                    do_not_optimize(buffer);
+                }
+            }, "one buffer at a time");
+        }
+};
+
+int main()
+{
+    Suite suite;
+    TestOperators operators;
+    TestAssertions assertions;
+    suite.add(operators);
+    suite.add(assertions);
+    return suite.run()==0 ? 0 : 1;
+}
@@ -62,6 +62,26 @@ class TestRatio : public Test{
             Ratio r2(3,5);
             assert_same_type(r1,r2,"type comparison");
             assert_not_same_type(r1,1/2,"types differents");
+            static_same_type<decltype(Ratio(1,2)+Ratio(3,5)), Ratio>("type of a sum");
+            static_not_same_type<decltype(Ratio(1,2).to_double()), Ratio>("type of the value");
+        }
+        void test_constants(){
+            // constexpr ratios are checked by the compiler
+            static_test<(Ratio(1,2)+Ratio(3,5)==Ratio(11,10))>("add (compile time)");
+            static_test<(Ratio(2,4)==Ratio(1,2))>("equals (compile time)");
+            static_test<(Ratio(1,3)!=Ratio(1,2))>("not equals (compile time)");
+            static_test<(Ratio(3,4).numerator()==3 && Ratio(3,4).denominator()==4)>("create (compile time)");
+        }
+        void test_properties(){
+            // the sum of two ratios is the sum of their values
+            for_all(std::make_tuple(gen::integer<int>(-100000,100000), gen::integer<int>(1,100000),
+                                    gen::integer<int>(-100000,100000), gen::integer<int>(1,100000)),
+                [](int a, int b, int c, int d){
+                    Ratio r(a,b);
+                    r += Ratio(c,d);
+                    double sum = (double)a/b+(double)c/d;
+                    return std::fabs(r.to_double()-sum) <= 1e-9*(1+std::fabs(sum));
+                }, "add (property)");
         }
     protected:
         void test_code() override{
@@ -71,6 +91,8 @@ class TestRatio : public Test{
             test_collections();       
             test_pointers();
             test_type();
+            test_constants();
+            test_properties();
         }
     public:
         TestRatio(std::ostream& stream):Test(stream){}
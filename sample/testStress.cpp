@@ -0,0 +1,120 @@
+#include "test.h"
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <mutex>
+#include <queue>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+
+using namespace tests;
+
+/**
+ * A queue shared by threads, locked by a mutex
+*/
+class SharedQueue
+{
+    private:
+        std::mutex mutex;
+        std::queue<std::uint64_t> values;
+    public:
+        void push(std::uint64_t value){
+            std::lock_guard<std::mutex> lock(mutex);
+            values.push(value);
+        }
+        bool pop(){
+            std::lock_guard<std::mutex> lock(mutex);
+            if(values.empty()) return false;
+            values.pop();
+            return true;
+        }
+        bool empty(){
+            std::lock_guard<std::mutex> lock(mutex);
+            return values.empty();
+        }
+};
+
+/**
+ * Stresses of right code : each thread runs all its calls, and the invariant holds after each round
+*/
+class TestRightCode : public Test
+{
+    protected:
+        void test_code() override{
+            SharedQueue queue;
+            std::atomic<long> lost(0);
+            stress(4, 20000, [&](unsigned, std::uint64_t i){
+                queue.push(i);
+                stress_point();
+                if(!queue.pop()) lost++;
+            }, [&]{ return queue.empty(); }, "push then pop");
+            assert_equal(0L, lost.load(), "a value to pop after each push");
+
+            // 1, 2 then 4 threads, for 10 rounds each
+            std::atomic<std::uint64_t> calls(0);
+            stress(4, 1000, [&](unsigned, std::uint64_t){ calls++; }, "atomic counter");
+            assert_equal((std::uint64_t)(1+2+4)*10*1000, calls.load(), "every call run");
+        }
+};
+
+/**
+ * Stresses which fail : their messages are checked by TestFailures
+*/
+class WrongCode : public Test
+{
+    public:
+        explicit WrongCode(std::ostream& output) : Test(output){}
+    protected:
+        void test_code() override{
+            // an increment split in a load and a store : a perturbation between them loses the increments of other threads
+            set_stress_perturbation(1);
+            std::atomic<long> counter(0), increments(0);
+            stress(2, 1000, [&](unsigned, std::uint64_t){
+                long value = counter.load(std::memory_order_relaxed);
+                stress_point();
+                counter.store(value+1, std::memory_order_relaxed);
+                increments++;
+            }, [&]{ return counter.load()==increments.load(); }, "lost increments");
+            // a thread which throws after 10 calls of 1 ms : the throughput counts the calls it has run
+            set_stress_rounds(1);
+            stress(1, 1000000000, [](unsigned, std::uint64_t i){
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                if(i==9) throw std::runtime_error("tenth call");
+            }, "exception");
+        }
+};
+
+/**
+ * Checks the messages of the stresses which fail : the failure, its seed and the throughput
+*/
+class TestFailures : public Test
+{
+    protected:
+        void test_code() override{
+            std::ostringstream text;
+            StreamReporter reporter(text);
+            WrongCode wrong(text);
+            wrong.set_reporter(&reporter);
+            wrong.run();
+            std::string output = text.str();
+            assert_equal(2, wrong.failed_count(), "both stresses fail");
+            assert_true(output.find("the invariant does not hold in the round 1 of 2 threads, replay with set_stress_seed(")!=std::string::npos, "invariant");
+            assert_true(output.find("an exception is thrown by the thread 0 (tenth call) in the round 1 of 1 thread, replay with set_stress_seed(")!=std::string::npos, "exception");
+            // about 1000 calls by second, 10^11 if the stopped calls were counted
+            std::size_t curve = output.find("\t1 thread : ", output.find("tenth call"));
+            assert_true(curve!=std::string::npos, "throughput shown");
+            double throughput = curve==std::string::npos ? 0 : std::strtod(output.c_str()+curve+12, nullptr);
+            assert_true(throughput>0 && throughput<2000, "throughput of the calls run");
+        }
+};
+
+int main()
+{
+    Suite suite;
+    TestRightCode right;
+    TestFailures failures;
+    suite.add(right);
+    suite.add(failures);
+    return suite.run()==0 ? 0 : 1;
+}
@@ -0,0 +1,9 @@
+/**
+ * Implementation of the framework, for suites compiled with TESTS_SEPARATE_COMPILATION :
+ * their files include test_decl.h, and this file is compiled once and linked with them.
+*/
+#if !defined(TESTS_SEPARATE_COMPILATION)
+#define TESTS_SEPARATE_COMPILATION
+#endif
+#define TESTS_IMPLEMENTATION
+#include "test.h"
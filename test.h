@@ -6,379 +6,5088 @@
 #include <algorithm>
 #include <chrono>
 #include <typeinfo>
+#include <vector>
+#include <deque>
+#include <memory>
+#include <sstream>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <ctime>
+#include <stdexcept>
+#include <cstring>
+#include <cstdio>
+#include <unordered_map>
+#include <unordered_set>
+#include <iterator>
+#include <type_traits>
+#include <cstdint>
+#include <limits>
+#include <tuple>
+#include <cstdlib>
+#include <fstream>
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#include <cpuid.h>
+#include <x86intrin.h>
+#elif defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#if defined(__GNUG__)
+#include <cxxabi.h>
+#include <cstdlib>
+#endif
+#if defined(__unix__) || defined(__APPLE__)
+#include <new>
+#include <csignal>
+#include <cstring>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <sys/uio.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <dirent.h>
+#include <fcntl.h>
+#include <cerrno>
+#include <pthread.h>
+#endif
+#if defined(__linux__)
+#include <sched.h>
+#include <elf.h>
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <sys/ioctl.h>
+#endif
+// coroutine tests (AsyncTest) : C++20 coroutines and epoll
+#if defined(__linux__) && defined(__cpp_impl_coroutine) && defined(__has_include)
+#if __has_include(<coroutine>)
+#define TESTS_COROUTINES
+#include <coroutine>
+#include <optional>
+#include <queue>
+#include <exception>
+#include <sys/epoll.h>
+#endif
+#endif
+
+#include "test_decl.h"
 
 namespace tests
 {
+	/**
+	 * @param name a mangled type name, as given by type_info::name()
+	 * @returns the human readable name of the type (when the compiler allows it)
+	*/
+	inline std::string demangle(const char* name)
+	{
+#if defined(__GNUG__)
+		int status=0;
+		char* readable = abi::__cxa_demangle(name, nullptr, nullptr, &status);
+		if(status==0 && readable!=nullptr){
+			std::string result(readable);
+			std::free(readable);
+			return result;
+		}
+#endif
+		return name;
+	}
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+	__attribute__((target("avx2")))
+	inline std::size_t first_mismatch_avx2(const unsigned char* a, const unsigned char* b, std::size_t size)
+	{
+		std::size_t i=0;
+		for(;i+32<=size;i+=32){
+			__m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a+i));
+			__m256i y = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b+i));
+			unsigned int different = ~(unsigned int)_mm256_movemask_epi8(_mm256_cmpeq_epi8(x,y));
+			if(different!=0) return i+__builtin_ctz(different);
+		}
+		for(;i<size;i++) if(a[i]!=b[i]) return i;
+		return size;
+	}
+	__attribute__((target("sse2")))
+	inline std::size_t first_mismatch_sse2(const unsigned char* a, const unsigned char* b, std::size_t size)
+	{
+		std::size_t i=0;
+		for(;i+16<=size;i+=16){
+			__m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a+i));
+			__m128i y = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b+i));
+			unsigned int different = (~(unsigned int)_mm_movemask_epi8(_mm_cmpeq_epi8(x,y))) & 0xffff;
+			if(different!=0) return i+__builtin_ctz(different);
+		}
+		for(;i<size;i++) if(a[i]!=b[i]) return i;
+		return size;
+	}
+#endif
+	inline std::size_t first_mismatch_words(const unsigned char* a, const unsigned char* b, std::size_t size)
+	{
+		std::size_t i=0;
+		for(;i+8<=size;i+=8){
+			unsigned long long x, y;
+			std::memcpy(&x, a+i, 8);
+			std::memcpy(&y, b+i, 8);
+			if(x!=y) break;
+		}
+		for(;i<size;i++) if(a[i]!=b[i]) return i;
+		return size;
+	}
+#if !defined(TESTS_SEPARATE_COMPILATION) || defined(TESTS_IMPLEMENTATION)
+	TESTS_INLINE std::size_t first_mismatch(const void* first, const void* second, std::size_t size)
+	{
+		const unsigned char* a = static_cast<const unsigned char*>(first);
+		const unsigned char* b = static_cast<const unsigned char*>(second);
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+		static const bool avx2 = __builtin_cpu_supports("avx2");
+		static const bool sse2 = __builtin_cpu_supports("sse2");
+		if(avx2) return first_mismatch_avx2(a,b,size);
+		if(sse2) return first_mismatch_sse2(a,b,size);
+#endif
+		return first_mismatch_words(a,b,size);
+	}
+#endif
+
+	/**
+	 * Tells if std::hash can hash values of type T
+	*/
+	template <typename T>
+	struct is_hashable
+	{
+		private:
+			template <typename U> static auto check(int) -> decltype(std::hash<U>()(std::declval<const U&>()), std::true_type());
+			template <typename U> static std::false_type check(...);
+		public:
+			static const bool value = decltype(check<T>(0))::value;
+	};
+
+	/**
+	 * Tells if values of type T can be ordered with operator<
+	*/
+	template <typename T>
+	struct is_less_comparable
+	{
+		private:
+			template <typename U> static auto check(int) -> decltype(bool(std::declval<const U&>() < std::declval<const U&>()), std::true_type());
+			template <typename U> static std::false_type check(...);
+		public:
+			static const bool value = decltype(check<T>(0))::value;
+	};
+
+	/**
+	 * Index of the values of a range, built once to check the membership of many values :
+	 * a hash set when values can be hashed, else a sorted array when they can be ordered, else the range itself.
+	 * The index refers to the values of the range, which must not change while it is used.
+	 * @tparam iterator the type of iterator of the range (a forward iterator)
+	*/
+	template <typename iterator, typename value_type = typename std::remove_cv<typename std::iterator_traits<iterator>::value_type>::type,
+		int strategy = is_hashable<value_type>::value ? 0 : is_less_comparable<value_type>::value ? 1 : 2>
+	class MembershipIndex;
+
+	template <typename iterator, typename value_type>
+	class MembershipIndex<iterator, value_type, 0>
+	{
+		private:
+			struct Hash
+			{
+				std::size_t operator()(const value_type* value) const { return std::hash<value_type>()(*value); }
+			};
+			struct Equal
+			{
+				bool operator()(const value_type* a, const value_type* b) const { return *a==*b; }
+			};
+			std::unordered_set<const value_type*, Hash, Equal> values;
+		public:
+			MembershipIndex(iterator first, iterator last){
+				for(;first!=last;++first) values.insert(&*first);
+			}
+			bool contains(const value_type& value) const { return values.count(&value)!=0; }
+	};
+
+	template <typename iterator, typename value_type>
+	class MembershipIndex<iterator, value_type, 1>
+	{
+		private:
+			std::vector<const value_type*> values;
+			static bool less(const value_type* a, const value_type* b) { return *a < *b; }
+		public:
+			MembershipIndex(iterator first, iterator last){
+				for(;first!=last;++first) values.push_back(&*first);
+				std::sort(values.begin(), values.end(), less);
+			}
+			bool contains(const value_type& value) const {
+				return std::binary_search(values.begin(), values.end(), &value, less);
+			}
+	};
+
+	template <typename iterator, typename value_type>
+	class MembershipIndex<iterator, value_type, 2>
+	{
+		private:
+			iterator first;
+			iterator last;
+		public:
+			MembershipIndex(iterator first, iterator last) : first(first), last(last){}
+			bool contains(const value_type& value) const { return std::find(first, last, value)!=last; }
+	};
+
+	/**
+	 * @returns the CPU time consumed by the calling thread, in nanoseconds.
+	 * Falls back to the process CPU time where per thread time is not available.
+	*/
+	inline double thread_cpu_time()
+	{
+#if defined(CLOCK_THREAD_CPUTIME_ID)
+		timespec ts;
+		if(clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts)==0)
+			return ts.tv_sec*1e9+ts.tv_nsec;
+#endif
+		return std::clock()*(1e9/CLOCKS_PER_SEC);
+	}
+
+	/**
+	 * @returns the maximum resident set size of the process, in kilobytes (0 where it is not available)
+	*/
+	inline long max_rss()
+	{
+#if defined(__unix__) || defined(__APPLE__)
+		struct rusage usage;
+		if(getrusage(RUSAGE_SELF, &usage)==0)
+#if defined(__APPLE__)
+			return usage.ru_maxrss/1024; // bytes
+#else
+			return usage.ru_maxrss;
+#endif
+#endif
+		return 0;
+	}
+
+	/**
+	 * Values of the performance counters of a thread over some measures (see PerfCounters)
+	*/
+	struct CounterValues
+	{
+		enum Event
+		{
+			cycles,
+			instructions,
+			l1d_misses, // reads which miss the level 1 data cache
+			llc_misses, // misses of the last level cache
+			branch_misses,
+			task_clock, // ns
+			page_faults,
+			context_switches,
+			events
+		};
+		double values[events];
+		bool measured[events]; // false when the event is not available
+
+		CounterValues(){
+			for(int i=0;i<events;i++){
+				values[i] = 0;
+				measured[i] = false;
+			}
+		}
+		CounterValues& operator+=(const CounterValues& other){
+			for(int i=0;i<events;i++){
+				values[i] += other.values[i];
+				measured[i] = measured[i] || other.measured[i];
+			}
+			return *this;
+		}
+	/**
+	 * @returns true if at least one event is measured
+	*/
+		bool any() const {
+			for(int i=0;i<events;i++) if(measured[i]) return true;
+			return false;
+		}
+	/**
+	 * @param operations the number of operations measured (0 : the totals are written)
+	 * @returns the values as a text, with the instructions per cycle : "IPC 2.5, per operation : 120 cycles, ..."
+	*/
+		std::string describe(double operations=0) const {
+			static const char* const names[] = { "cycles", "instructions", "L1D misses", "LLC misses", "branch misses",
+				"ns of task clock", "page faults", "context switches" };
+			std::ostringstream text;
+			double divisor = operations>0 ? operations : 1;
+			const char* separator = "";
+			if(measured[cycles] && measured[instructions] && values[cycles]>0){
+				text << "IPC " << values[instructions]/values[cycles];
+				separator = ", ";
+			}
+			if(operations>0){
+				text << separator << "per operation :";
+				separator = " ";
+			}
+			for(int i=0;i<events;i++){
+				if(!measured[i]) continue;
+				text << separator << values[i]/divisor << ' ' << names[i];
+				separator = ", ";
+			}
+			text << '.';
+			return text.str();
+		}
+	};
+
+	/**
+	 * Performance counters of the calling thread, read by perf_event_open (Linux only) : a group of hardware
+	 * events (cycles, instructions, L1D and LLC misses, branch misses) when the processor exposes them, which
+	 * is often not the case in virtual machines, and a group of software events (task clock, page faults,
+	 * context switches). Only the user mode is counted, so perf_event_paranoid up to 2 is enough.
+	 * Elsewhere, or when perf_event_open is denied, no event is available.
+	*/
+	class PerfCounters
+	{
+		private:
+			int descriptors[CounterValues::events];
+			int hardware_leader;
+			int software_leader;
+			PerfCounters(const PerfCounters&) = delete;
+			PerfCounters& operator=(const PerfCounters&) = delete;
+
+#if defined(__linux__)
+			static int open_event(std::uint32_t type, std::uint64_t config, int leader){
+				perf_event_attr attributes;
+				std::memset(&attributes, 0, sizeof(attributes));
+				attributes.size = sizeof(attributes);
+				attributes.type = type;
+				attributes.config = config;
+				attributes.disabled = leader<0 ? 1 : 0;
+				attributes.exclude_kernel = 1;
+				attributes.exclude_hv = 1;
+				attributes.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+				return (int)syscall(__NR_perf_event_open, &attributes, 0, -1, leader, PERF_FLAG_FD_CLOEXEC);
+			}
+			static void control(int leader, unsigned long request){
+				if(leader>=0) ioctl(leader, request, PERF_IOC_FLAG_GROUP);
+			}
+#endif
+		public:
+		/**
+		 * Opens the counters of the calling thread : they count only this thread
+		*/
+			PerfCounters() : hardware_leader(-1), software_leader(-1){
+				for(int i=0;i<CounterValues::events;i++) descriptors[i] = -1;
+#if defined(__linux__)
+				hardware_leader = descriptors[CounterValues::cycles] = open_event(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES, -1);
+				if(hardware_leader>=0){
+					descriptors[CounterValues::instructions] = open_event(PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS, hardware_leader);
+					descriptors[CounterValues::l1d_misses] = open_event(PERF_TYPE_HW_CACHE,
+						PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ<<8) | (PERF_COUNT_HW_CACHE_RESULT_MISS<<16), hardware_leader);
+					descriptors[CounterValues::llc_misses] = open_event(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES, hardware_leader);
+					descriptors[CounterValues::branch_misses] = open_event(PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES, hardware_leader);
+				}
+				software_leader = descriptors[CounterValues::task_clock] = open_event(PERF_TYPE_SOFTWARE, PERF_COUNT_SW_TASK_CLOCK, -1);
+				if(software_leader>=0){
+					descriptors[CounterValues::page_faults] = open_event(PERF_TYPE_SOFTWARE, PERF_COUNT_SW_PAGE_FAULTS, software_leader);
+					descriptors[CounterValues::context_switches] = open_event(PERF_TYPE_SOFTWARE, PERF_COUNT_SW_CONTEXT_SWITCHES, software_leader);
+				}
+#endif
+			}
+			~PerfCounters(){
+#if defined(__linux__)
+				for(int i=0;i<CounterValues::events;i++) if(descriptors[i]>=0) close(descriptors[i]);
+#endif
+			}
+		/**
+		 * @returns true if some events are counted
+		*/
+			bool available() const { return hardware_leader>=0 || software_leader>=0; }
+		/**
+		 * @returns true if the hardware events are counted, false if only the software ones are
+		*/
+			bool hardware() const { return hardware_leader>=0; }
+		/**
+		 * Resets the counters and starts to count
+		*/
+			void start(){
+#if defined(__linux__)
+				control(hardware_leader, PERF_EVENT_IOC_RESET);
+				control(software_leader, PERF_EVENT_IOC_RESET);
+				control(software_leader, PERF_EVENT_IOC_ENABLE);
+				control(hardware_leader, PERF_EVENT_IOC_ENABLE);
+#endif
+			}
+		/**
+		 * Stops to count
+		 * @returns the values counted since start(), scaled when the events were multiplexed
+		*/
+			CounterValues stop(){
+				CounterValues result;
+#if defined(__linux__)
+				control(hardware_leader, PERF_EVENT_IOC_DISABLE);
+				control(software_leader, PERF_EVENT_IOC_DISABLE);
+				for(int i=0;i<CounterValues::events;i++){
+					std::uint64_t data[3]; // value, time enabled, time running
+					if(descriptors[i]<0 || read(descriptors[i], data, sizeof(data))!=(ssize_t)sizeof(data) || data[2]==0) continue;
+					result.values[i] = data[2]<data[1] ? (double)data[0]*data[1]/data[2] : (double)data[0];
+					result.measured[i] = true;
+				}
+#endif
+				return result;
+			}
+	};
+
+	/**
+	 * Low overhead clock : reads the invariant time stamp counter of x86 processors, calibrated
+	 * against std::chrono::steady_clock on first use. Falls back to steady_clock when the counter
+	 * is not invariant (or not available), so it is always monotonic.
+	*/
+	class Clock
+	{
+		private:
+			struct Calibration
+			{
+				bool tsc;
+				double ns_per_tick;
+			};
+			static bool invariant_tsc(){
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+				unsigned int eax, ebx, ecx, edx;
+				if(__get_cpuid_max(0x80000000, nullptr) < 0x80000007) return false;
+				__cpuid(0x80000007, eax, ebx, ecx, edx);
+				return (edx & (1u<<8)) != 0;
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+				int info[4];
+				__cpuid(info, 0x80000000);
+				if((unsigned)info[0] < 0x80000007) return false;
+				__cpuid(info, 0x80000007);
+				return (info[3] & (1<<8)) != 0;
+#else
+				return false;
+#endif
+			}
+			static unsigned long long steady(){
+				return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+			}
+			static unsigned long long tsc(){
+#if ((defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))) || (defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86)))
+				return __rdtsc();
+#else
+				return steady();
+#endif
+			}
+			static const Calibration& calibration(){
+				static const Calibration value = [](){
+					Calibration result;
+					result.tsc = invariant_tsc();
+					result.ns_per_tick = 1;
+					if(result.tsc){
+						unsigned long long start = steady(), ticks = tsc(), stop;
+						do stop = steady(); while(stop-start < 10000000); // 10 ms
+						unsigned long long elapsed = tsc()-ticks;
+						if(elapsed==0) result.tsc = false;
+						else result.ns_per_tick = double(stop-start)/double(elapsed);
+					}
+					return result;
+				}();
+				return value;
+			}
+		public:
+		/**
+		 * @returns the current time, in ticks of the clock
+		*/
+			static unsigned long long ticks(){
+				return calibration().tsc ? tsc() : steady();
+			}
+		/**
+		 * @returns the duration of a tick, in nanoseconds
+		*/
+			static double ns_per_tick(){
+				return calibration().ns_per_tick;
+			}
+		/**
+		 * @returns true if the clock reads the time stamp counter, false if it uses steady_clock
+		*/
+			static bool uses_tsc(){
+				return calibration().tsc;
+			}
+		/**
+		 * @param ticks a duration in ticks
+		 * @returns the duration in nanoseconds
+		*/
+			static double to_ns(unsigned long long ticks){
+				return ticks*ns_per_tick();
+			}
+	};
+
 /**
 * simple chronometer
 */
 	class Chrono
 	{
 		private:
-			std::chrono::high_resolution_clock::time_point startTime;
-			std::chrono::high_resolution_clock::time_point stopTime;
+			unsigned long long startTime;
+			unsigned long long stopTime;
 		public:
+			Chrono() : startTime(0), stopTime(0){}
 	/**
 	* start the measure
 	*/
 			void start(){
-				startTime = std::chrono::high_resolution_clock::now();
+				startTime = Clock::ticks();
 			}
 	/**
 	* stop the measure
 	*/
 			void stop(){
-				stopTime = std::chrono::high_resolution_clock::now();
+				stopTime = Clock::ticks();
 			}
 	/**
 	* compute time
 	* @returns the time of measure, in milliseconds
 	*/
 			double time(){
-				return std::chrono::nanoseconds(stopTime-startTime).count()/1000000.0;
+				return Clock::to_ns(stopTime-startTime)/1000000.0;
 			}
 	};
 
 	/**
-	 * Very simple class to make units tests in C++
-	 * To create a test case, you must inherit this class and overrides test_code
-	 * This class contains a lot of assert_xx methods to make tests
-	 * It computes the times taken for tests
-	 * All outputs are sent to an standard output stream (who may be std::cout but not only)
-	 * @author alexandre guidet
-	 * @version 1
-	 * @see https://github.com/AlexandreGuidet/SimpliestCPPUnitTests
+	 * Hierarchical timer wheel served by a single thread, shared by all the watch dogs of the process.
+	 * The wheel has 4 levels of 64 slots with a 1 ms tick, so it covers about 4.6 hours without
+	 * cascading again ; timers are intrusive doubly-linked nodes, so arming and cancelling are O(1).
+	 * Callbacks are called on the wheel thread : they must be short.
 	*/
-	class Test
+	class TimerWheel
 	{
-		private:                       
-			int failed; 
-			int passed;
-			std::ostream& output;
-			Chrono chrono;
 		public:
 		/**
-		 * Initialize the test. 
-		 * @param output the stream to output the tests (default : the standard output)
-		*/
-			Test(std::ostream& output=std::cout) : output(output), failed(0),passed(0){}
-			virtual ~Test(){}
-		/**
-		 * Runs the test and outputs the results on the stream
+		 * A timer armed on the wheel. It must stay alive while it is armed.
 		*/
-			void run(){
-				failed=0;
-				passed=0;
-				print_header();
-				chrono.start();
-				try{                    
-					test_code();                    
-				}                
-				catch(...){
-					fail("*** exception occurs ***");
-					failed++;
-				}                                
-				chrono.stop();
-				print_resume();                
+			struct Timer
+			{
+				Timer* prev;
+				Timer* next;
+				unsigned long long expiry;
+				std::function<void()> callback;
+				bool armed;
+				bool firing;
+				Timer() : prev(nullptr), next(nullptr), expiry(0), armed(false), firing(false){}
+			};
+		private:
+			static const int bits = 6;
+			static const int slots = 1<<bits;
+			static const int levels = 4;
+			Timer wheel[levels][slots]; // sentinels of circular lists
+			unsigned long long current; // current tick, in ms since the creation of the wheel
+			std::chrono::steady_clock::time_point origin;
+			std::mutex lock;
+			std::condition_variable changed;
+			std::condition_variable fired;
+			std::thread worker;
+			bool stopping;
+			int pending;
+
+			TimerWheel() : current(0), origin(std::chrono::steady_clock::now()), stopping(false), pending(0){
+				for(int l=0;l<levels;l++)
+					for(int s=0;s<slots;s++)
+						wheel[l][s].prev = wheel[l][s].next = &wheel[l][s];
 			}
 
-		private:
-			void print_header(){
-				output << "Start of unit tests.\r\n";
+			unsigned long long now() const {
+				return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now()-origin).count();
 			}
-			void print_resume(){
-				output << "Tests ended. "<<passed<<" tests passed and "<<failed<<" failed.\r\n";
-				output << "Total test time is "<<chrono.time()<< " ms.\r\n";
+			static void link(Timer& head, Timer& timer){
+				timer.prev = head.prev;
+				timer.next = &head;
+				head.prev->next = &timer;
+				head.prev = &timer;
 			}
-			void print_result(std::string name, bool pass){
-				output << "\ttest "<<name << ((pass)?" passed.\r\n":" failed ") ;
+			static void unlink(Timer& timer){
+				timer.prev->next = timer.next;
+				timer.next->prev = timer.prev;
+				timer.prev = timer.next = nullptr;
 			}
-			void newline(){
-				output << "\r\n";
+			void insert(Timer& timer){
+				unsigned long long delta = timer.expiry>current ? timer.expiry-current : 0;
+				unsigned long long expiry = timer.expiry>current ? timer.expiry : current;
+				int level=0;
+				while(level<levels-1 && delta >= (1ull<<(bits*(level+1)))) level++;
+				if(delta >= (1ull<<(bits*levels))) // beyond the wheel : parked in the last slot reachable, cascaded later
+					expiry = current + (1ull<<(bits*levels)) - 1;
+				link(wheel[level][(expiry>>(bits*level))&(slots-1)], timer);
+			}
+			void cascade(int level){
+				Timer& head = wheel[level][(current>>(bits*level))&(slots-1)];
+				while(head.next!=&head){
+					Timer& timer = *head.next;
+					unlink(timer);
+					insert(timer);
+				}
+			}
+			// advances one tick and moves expired timers to the list to fire
+			void tick(std::vector<Timer*>& expired){
+				current++;
+				for(int l=1;l<levels && (current&((1ull<<(bits*l))-1))==0;l++)
+					cascade(l);
+				Timer& head = wheel[0][current&(slots-1)];
+				while(head.next!=&head){
+					Timer& timer = *head.next;
+					unlink(timer);
+					if(timer.expiry>current){ // parked timer not yet expired
+						insert(timer);
+						continue;
+					}
+					timer.armed=false;
+					timer.firing=true;
+					pending--;
+					expired.push_back(&timer);
+				}
+			}
+			// delay before the next tick which has something to do (bounded by one turn of the first level)
+			unsigned long long next_event() const {
+				for(unsigned long long t=1;t<=(unsigned long long)slots;t++){
+					unsigned long long at=current+t;
+					const Timer& head = wheel[0][at&(slots-1)];
+					if(head.next!=&head || (at&(slots-1))==0) return t;
+				}
+				return slots;
+			}
+			void loop(){
+				std::vector<Timer*> expired;
+				std::unique_lock<std::mutex> guard(lock);
+				while(!stopping){
+					if(pending==0){
+						changed.wait(guard);
+						continue;
+					}
+					unsigned long long target = now();
+					if(target<=current){
+						changed.wait_for(guard, std::chrono::milliseconds(next_event()));
+						target = now();
+					}
+					while(current<target) tick(expired);
+					if(expired.empty()) continue;
+					guard.unlock();
+					for(Timer* timer : expired)
+						timer->callback();
+					guard.lock();
+					for(Timer* timer : expired)
+						timer->firing=false;
+					expired.clear();
+					fired.notify_all();
+				}
+			}
+		public:
+			~TimerWheel(){
+				{
+					std::lock_guard<std::mutex> guard(lock);
+					stopping=true;
+				}
+				changed.notify_all();
+				if(worker.joinable()) worker.join();
 			}
-		protected:
 		/**
-		 * Contains the code of the test
+		 * @returns the wheel of the process (its thread is started on first use)
 		*/
-			virtual void test_code() = 0;
-
-			template<typename T> void print_values(const T& expected, const T& computed)
-			{
-				output << expected<< " expected but "<<computed<<" gets.\r\n";
+			static TimerWheel& instance(){
+				static TimerWheel wheel;
+				return wheel;
 			}
 		/**
-		 * Assert a value is true
-		 * @param value the value who must be true
-		 * @param name the name of the test (not mandatory)
+		 * Arms a timer. If the timer was already armed, it is re-armed.
+		 * @param timer the timer, whose callback is set
+		 * @param delay the delay before the call of the callback, in milliseconds
 		*/
-			void assert_true(bool value, std::string name="")
-			{
-				if(!value) failed++;
-				else passed++;
-				print_result(name,value);
-				if(!value) print_values(true,false);
+			void arm(Timer& timer, unsigned long delay){
+				std::lock_guard<std::mutex> guard(lock);
+				if(!worker.joinable()) worker = std::thread(&TimerWheel::loop, this);
+				if(timer.armed){
+					unlink(timer);
+					pending--;
+				}
+				if(pending==0) current = std::max(current, now()); // empty wheel : no need to tick up to now
+				timer.expiry = now() + (delay==0 ? 1 : delay);
+				timer.armed=true;
+				pending++;
+				insert(timer);
+				changed.notify_one();
 			}
 		/**
-		 * Assert a value is false
-		 * @param value the value who must be false
-		 * @param name the name of the test (not mandatory)
+		 * Cancels a timer. If its callback is running on another thread, waits for its end.
+		 * @param timer the timer
 		*/
-			void assert_false(bool value, std::string name="")
-			{
-				if(value) failed++;
-				else passed++;
-				print_result(name,!value);
-				if(value) print_values(false,true);
+			void cancel(Timer& timer){
+				std::unique_lock<std::mutex> guard(lock);
+				if(timer.armed){
+					unlink(timer);
+					timer.armed=false;
+					pending--;
+				}
+				if(std::this_thread::get_id()!=worker.get_id())
+					while(timer.firing) fired.wait(guard);
 			}
+	};
+
+	/**
+	 * A watch dog calls a function when its delay is over, unless it is cancelled before.
+	 * All watch dogs share the thread of the TimerWheel.
+	*/
+	class WatchDog
+	{
+		private:
+			unsigned long delay;
+			TimerWheel::Timer timer;
+		public:
 		/**
-		 * Failed the test
-		 *  @param name the name of the test (not mandatory)
+		 * @param delay the delay, in milliseconds (infinite : the watch dog never fires)
 		*/
-			void fail(std::string name="")
-			{
-				failed++;
-				print_result(name,false);
-				newline();
-			}
+			explicit WatchDog(unsigned long delay) : delay(delay){}
+			WatchDog(const WatchDog&) = delete;
+			WatchDog& operator=(const WatchDog&) = delete;
+			~WatchDog(){ cancel(); }
 		/**
-		 * Pass the test
-		 *  @param name the name of the test (not mandatory)
+		 * Starts (or restarts) the watch dog
+		 * @param callback a functionnal object called on the watch dog thread when the delay is over
 		*/
-			void pass(std::string name="")
-			{
-				passed++;
-				print_result(name,true);
+			void start(std::function<void()> callback){
+				cancel();
+				if(delay==infinite) return;
+				timer.callback = std::move(callback);
+				TimerWheel::instance().arm(timer, delay);
 			}
 		/**
-		 * Asserts two values are equal
-		 * @param expected the value expected
-		 * @param value the value computed by the test
-		 * @param name the name of the test (not mandatory)
-		 * @tparam T the type of values
+		 * Cancels the watch dog. When it returns, the callback is not running and will not be called.
 		*/
-			template <typename T> 
-			void assert_equal(const T& expected, const T& value,std::string name=""){
-				bool pass=expected==value;
-				// special case for nan
-				if (std::isnan(expected) && std::isnan(value))
-					pass = true;
-				
-				if(!pass)
-					failed++;
-				else passed++;
-				print_result(name,pass);
-				if(!pass) print_values(expected,value);
-			}      
-		/**
-		 * Asserts two float values are equal
-		 * @param expected the value expected
-		 * @param value the value computed by the test
-		 * @param precision the precision of the test 
-		 * @param name the name of the test (not mandatory)
-		*/      
-			void assert_equal(const double& expected, const double& value, double precision, std::string name=""){
-				double delta = std::abs(expected-value);
-				bool pass = delta<precision;
-				if(!pass) failed++; 
-				else passed++;
-				print_result(name,pass);
-				if(!pass) print_values(expected,value);
+			void cancel(){
+				TimerWheel::instance().cancel(timer);
 			}
+	};
 
-		/**
-		 * Asserts two values are not equal
-		 * @param not_expected the value expected to be different
-		 * @param value the value computed by the test
-		 * @param name the name of the test (not mandatory)
-		 * @tparam T the type of values
-		*/            
-			template <typename T> 
-			void assert_not_equal(const T& not_expected, const T& value, std::string name=""){
-				bool pass=not_expected!=value;
-				if(!pass) failed++;
-				else passed++;
-				print_result(name,pass);
+	/**
+	 * Reporter which writes the results as text, synchronously, to a stream
+	*/
+	class StreamReporter : public Reporter
+	{
+		private:
+			std::ostream& output;
+			void write(const char* text, std::size_t size){
+				output.rdbuf()->sputn(text, (std::streamsize)size);
 			}
+		public:
 		/**
-		 * Asserts two float values are not equal
-		 * @param not_expected the value expected
-		 * @param value the value computed by the test
-		 * @param precision the precision of the test 
-		 * @param name the name of the test (not mandatory)
-		*/             
-			void assert_not_equal(const double& not_expected, const double& value, double precision, std::string name=""){                
-				double delta = std::abs(not_expected-value);
-				bool pass = delta > precision;
-				if(!pass) failed++;
-				else passed++;
-				print_result(name,pass);
-			}
-		/**
-		 * Assert an expression throws an exception
-		 * @param testing a functionnal object (ie lambda expression) with code who can throw except
-		 * @param name the name of the test (not mandatory)
-		 * @tparam except the exception type
-		 * @tparam function the functionnal type
+		 * @param output the stream to write to
 		*/
-			template <typename except, typename function> void assert_throws( function testing, std::string name="")
-			{
-				try
-				{
-					testing();
-					fail(name);
-				}
-				catch(const except& e)
-				{
-					pass(name);
-				}
-				catch(...)
-				{
-					fail(name);
-				}
-				
+			explicit StreamReporter(std::ostream& output) : output(output){}
+			void started(Name) override {
+				write("Start of unit tests.\r\n",22);
 			}
-			
-		/**
-		 * Asserts a collection contains a value
-		 * @param begin the first element of collection
-		 * @param end the invalid element of collection (after last)
-		 * @param value the value to find
-		 * @param name the name of the test (not mandatory)
-		 * @tparam iterator the type of iterator
-		 * @tparam T the type of the value
-		*/
-			template <typename iterator, typename T>
-			void assert_contains(iterator begin, iterator end, const T& value, std::string name="")
+			void assertion(Name name, bool pass) override {
+				// the buffer is read once : each write is a virtual call which could change it
+				std::streambuf* buffer = output.rdbuf();
+				buffer->sputn("\ttest ",6);
+				buffer->sputn(name.data(),(std::streamsize)name.size());
+				if(pass) buffer->sputn(" passed.\r\n",10);
+				else buffer->sputn(" failed ",8);
+			}
+			void message(Name text) override {
+				write(text.data(),text.size());
+				write("\r\n",2);
+			}
+			void ended(int passed, int failed, double time) override {
+				output << "Tests ended. "<<passed<<" tests passed and "<<failed<<" failed.\r\n";
+				output << "Total test time is "<<time<< " ms.\r\n";
+			}
+			void flush() override {
+				output.flush();
+			}
+	};
+
+	/**
+	 * Reporter which keeps I/O out of the thread under test : results are pushed as fixed-size records
+	 * into a lock-free single producer / single consumer ring, and a background thread formats them
+	 * by batches and writes them to the stream (or with large writev calls to a file descriptor).
+	 * One background thread, started on first use, serves all the asynchronous reporters of the process.
+	*/
+	class AsyncReporter : public Reporter
+	{
+		private:
+			enum Kind : unsigned char { header, passed_line, failed_line, fragment, message_line, resume };
+			struct Record
 			{
-				bool pass=std::find(begin,end,value)!=end;
-								
-				if(pass)
-					passed++;
-				else
-					failed++;
-				print_result(name,pass);
-				if(!pass) output << "element not founded\r\n";
-			}
-		/**
-		 * Asserts a collection not contains a value
-		 * @param begin the first element of collection
-		 * @param end the invalid element of collection (after last)
-		 * @param value the value to find
-		 * @param name the name of the test (not mandatory)
-		 * @tparam iterator the type of iterator
-		 * @tparam T the type of the value
-		*/            
-			template <typename iterator, typename T>
-			void assert_not_contains(iterator begin, iterator end, const T& value, std::string name="")
-			{
-				bool pass=std::find(begin,end,value)==end;
-								
-				if(pass)
-					passed++;
-				else
-					failed++;
-				print_result(name,pass);
-				if(!pass) output << "element founded\r\n";
-			}
-		/**
-		 * Asserts two collections are identical (same elements in same order)
-		 * collections may be differents (list and vector) but elements type must be identical
-		 * @tparam iter1 type of iterator of the first collection
-		 * @tparam iter2 type of iterator of the second collection
-		 * @param first1 begin of the first collection
-		 * @param last1 end of the first collection
-		 * @param first2 begin of the second collection
-		 * @param last2 end of the second collection
-		 * @param name the name of the test (not mandatory)
-		*/
-			template <typename iter1, typename iter2>
-			void assert_collection_equals(iter1 first1, iter1 last1, iter2 first2, iter2 last2,std::string name="")
-			{
-				bool pass=true;
-				iter1 i1 = first1;
-				iter2 i2 = first2;
-				bool end=false;
-				while(!end){
-					if(i1==last1 || i2==last2)
-					{
-						end=true;
-						if(i1!=last1 || i2!=last2)
-							pass=false;
-					}
-					else{
-						if(*i1 != *i2){
-							pass=false;
-							end=true;
+				Kind kind;
+				unsigned char size;
+				char data[62];
+			};
+			static const std::size_t capacity = 4096; // records
+			static const std::size_t text_size = sizeof(Record().data);
+			struct Piece
+			{
+				const char* data;
+				std::size_t size;
+			};
+
+			// the thread which writes the records of every reporter
+			class Consumer
+			{
+				private:
+					std::mutex lock;
+					std::condition_variable wake; // the worker waits for records
+					std::condition_variable drained; // flush and remove wait for a pass of the worker
+					std::vector<AsyncReporter*> reporters;
+					bool started; // the worker runs in this process
+					std::atomic<bool> sleeping;
+					bool draining; // a pass writes the reporters out of the lock
+					Consumer() : started(false), sleeping(false), draining(false){
+#if defined(__unix__) || defined(__APPLE__)
+						pthread_atfork([](){ instance().lock.lock(); }, [](){ instance().lock.unlock(); }, [](){ instance().forked(); });
+#endif
+					}
+					// called with the lock
+					void start(){
+						if(started) return;
+						std::thread(&Consumer::loop, this).detach();
+						started = true;
+					}
+					// in a child process, which has no worker : the records pushed before the fork are written by the parent,
+					// and the first push starts another worker
+					void forked(){
+						started = false;
+						draining = false;
+						sleeping.store(true);
+						for(AsyncReporter* reporter : reporters)
+							reporter->tail.store(reporter->head.load());
+						lock.unlock();
+					}
+					void loop(){
+						std::vector<Piece> pieces;
+						std::deque<std::string> numbers;
+						std::vector<AsyncReporter*> current;
+						std::unique_lock<std::mutex> guard(lock);
+						for(;;){
+							// formats and writes out of the lock : the tests which add or remove a reporter do not wait for the I/O
+							current = reporters;
+							draining = true;
+							guard.unlock();
+							bool written=false;
+							for(AsyncReporter* reporter : current)
+								if(reporter->drain(pieces, numbers)) written=true;
+							guard.lock();
+							draining = false;
+							drained.notify_all();
+							if(written) continue;
+							// announced before the rings are read again : a record is either seen here, or its push sees the worker sleeping
+							sleeping.store(true);
+							bool pending=false;
+							for(AsyncReporter* reporter : reporters)
+								if(reporter->pending()) pending=true;
+							if(!pending) wake.wait(guard);
+							sleeping.store(false, std::memory_order_relaxed);
 						}
-						else{
-							++i1;
-							++i2;
+					}
+				public:
+					// never destroyed : tests and reporters may be destroyed after the static objects
+					static Consumer& instance(){
+						static Consumer* consumer = new Consumer();
+						return *consumer;
+					}
+					void add(AsyncReporter* reporter){
+						std::lock_guard<std::mutex> guard(lock);
+						start();
+						reporters.push_back(reporter);
+					}
+					// when it returns, the reporter is not written anymore
+					void remove(AsyncReporter* reporter){
+						std::unique_lock<std::mutex> guard(lock);
+						reporters.erase(std::find(reporters.begin(), reporters.end(), reporter));
+						drained.wait(guard, [this](){ return !draining; });
+					}
+					// called after a push (which stores its head in the same total order) : only the first record after a pause of the worker takes the lock
+					void notify(){
+						if(sleeping.load() && sleeping.exchange(false)){
+							std::lock_guard<std::mutex> guard(lock);
+							start();
+							wake.notify_one();
 						}
 					}
+					// waits until the records of the reporter are written
+					void flush(AsyncReporter* reporter){
+						std::size_t written = reporter->head.load(std::memory_order_relaxed);
+						std::unique_lock<std::mutex> guard(lock);
+						start();
+						sleeping.store(false, std::memory_order_relaxed);
+						wake.notify_one();
+						drained.wait(guard, [&](){ return reporter->tail.load(std::memory_order_acquire)>=written; });
+					}
+			};
+
+			std::vector<Record> ring;
+			std::atomic<std::size_t> head; // written by the test thread
+			std::atomic<std::size_t> tail; // written by the background thread
+			std::ostream* stream;
+			int fd;
+			Consumer& consumer;
+
+			void push(Kind kind, const char* data, std::size_t size){
+				std::size_t position = head.load(std::memory_order_relaxed);
+				if(position-tail.load(std::memory_order_acquire) >= capacity) consumer.flush(this);
+				Record& record = ring[position%capacity];
+				record.kind = kind;
+				record.size = (unsigned char)size;
+				std::memcpy(record.data, data, size);
+				head.store(position+1);
+				consumer.notify();
+			}
+			// pushes a text longer than a record : the last part gets the kind
+			void push_text(Kind kind, const char* data, std::size_t size){
+				while(size>text_size){
+					push(fragment, data, text_size);
+					data += text_size;
+					size -= text_size;
 				}
-				if(pass) passed++;
-				else failed++;
-				print_result(name,pass);
-				if(!pass) newline();
+				push(kind, data, size);
 			}
 
-		/**
-		 * Asserts a pointer is null
-		 * @tparam T type of pointer
-		 * @param pointer the pointer to test
-		 * @param name name of the test (not mandatory)
-		*/
-			template <typename T>
-			void assert_null(const T* pointer,std::string name="")
-			{
-				bool pass = pointer==nullptr;
-				print_result(name,pass);
-				if(!pass) output << "pointer is not null !\r\n";
+			void write(const std::vector<Piece>& pieces){
+#if defined(__unix__) || defined(__APPLE__)
+				if(fd>=0){
+					std::vector<iovec> vectors(pieces.size());
+					for(std::size_t i=0;i<pieces.size();i++){
+						vectors[i].iov_base = const_cast<char*>(pieces[i].data);
+						vectors[i].iov_len = pieces[i].size;
+					}
+					std::size_t first=0;
+					while(first<vectors.size()){
+						int count = (int)std::min<std::size_t>(vectors.size()-first, 1024);
+						ssize_t written = ::writev(fd, &vectors[first], count);
+						if(written<0){
+							if(errno==EINTR) continue;
+							return;
+						}
+						// skips what is written, the rest of a partial write is written again
+						while(first<vectors.size() && (std::size_t)written>=vectors[first].iov_len){
+							written -= vectors[first].iov_len;
+							first++;
+						}
+						if(first<vectors.size()){
+							vectors[first].iov_base = static_cast<char*>(vectors[first].iov_base)+written;
+							vectors[first].iov_len -= written;
+						}
+					}
+					return;
+				}
+#endif
+				for(const Piece& piece : pieces)
+					stream->write(piece.data, (std::streamsize)piece.size);
+				stream->flush();
+			}
+			// formats and writes the records in [from, to)
+			void consume(std::size_t from, std::size_t to, std::vector<Piece>& pieces, std::deque<std::string>& numbers){
+				pieces.clear();
+				numbers.clear();
+				for(std::size_t i=from;i<to;i++){
+					const Record& record = ring[i%capacity];
+					Piece content = { record.data, record.size };
+					switch(record.kind){
+						case header: pieces.push_back(Piece{"Start of unit tests.\r\n",22}); break;
+						case passed_line:
+							pieces.push_back(Piece{"\ttest ",6});
+							pieces.push_back(content);
+							pieces.push_back(Piece{" passed.\r\n",10});
+							break;
+						case failed_line:
+							pieces.push_back(Piece{"\ttest ",6});
+							pieces.push_back(content);
+							pieces.push_back(Piece{" failed ",8});
+							break;
+						case fragment: pieces.push_back(content); break;
+						case message_line:
+							pieces.push_back(content);
+							pieces.push_back(Piece{"\r\n",2});
+							break;
+						case resume: {
+							int counters[2];
+							double time;
+							std::memcpy(counters, record.data, sizeof(counters));
+							std::memcpy(&time, record.data+sizeof(counters), sizeof(time));
+							std::ostringstream resume;
+							resume << "Tests ended. "<<counters[0]<<" tests passed and "<<counters[1]<<" failed.\r\n";
+							resume << "Total test time is "<<time<< " ms.\r\n";
+							numbers.push_back(resume.str());
+							pieces.push_back(Piece{numbers.back().data(), numbers.back().size()});
+							break;
+						}
+					}
+				}
+				write(pieces);
+			}
+			// writes the records pushed since the last call, returns false if there was none
+			bool drain(std::vector<Piece>& pieces, std::deque<std::string>& numbers){
+				std::size_t from = tail.load(std::memory_order_relaxed);
+				std::size_t to = head.load(std::memory_order_acquire);
+				if(from==to) return false;
+				consume(from, to, pieces, numbers);
+				tail.store(to, std::memory_order_release);
+				return true;
 			}
+			bool pending() const {
+				return tail.load(std::memory_order_relaxed)!=head.load();
+			}
+		public:
 		/**
-		 * Asserts a pointer is not null
-		 * @tparam T type of pointer
-		 * @param pointer the pointer to test
-		 * @param name name of the test (not mandatory)
+		 * @param output the stream to write to
 		*/
-			template <typename T>
-			void assert_not_null(const T* pointer, std::string name=""){
-				bool pass = pointer!=nullptr;
-				print_result(name,pass);
-				if(!pass) output << "pointer is null !\r\n";
+			explicit AsyncReporter(std::ostream& output)
+				: ring(capacity), head(0), tail(0), stream(&output), fd(-1), consumer(Consumer::instance()){
+				consumer.add(this);
 			}
-
+#if defined(__unix__) || defined(__APPLE__)
 		/**
-		 * Asserts two values have the same type
-		 * @tparam T1 the type of value 1
-		 * @tparam T2 the type of value 2
-		 * @param value1 the first value
-		 * @param value2 the second value
-		 * @param name name of the test (not mandatory)
+		 * @param fd the file descriptor to write to (not closed by the reporter)
 		*/
-			template <typename T1, typename T2>
-			void assert_same_type(const T1& value1, const T2& value2, std::string name=""){
-				bool pass = typeid(value1)==typeid(value2);
-				print_result(name,pass);
-				if(!pass) output << "not the same type !\r\n";
+			explicit AsyncReporter(int fd)
+				: ring(capacity), head(0), tail(0), stream(nullptr), fd(fd), consumer(Consumer::instance()){
+				consumer.add(this);
 			}
-
-		/**
-		 * Asserts two values have differents types
-		 * @tparam T1 the type of value 1
-		 * @tparam T2 the type of value 2
-		 * @param value1 the first value
-		 * @param value2 the second value
-		 * @param name name of the test (not mandatory)
-		*/            
-			template <typename T1, typename T2>
-			void assert_not_same_type(const T1& value1, const T2& value2, std::string name=""){
-				bool pass = typeid(value1)!=typeid(value2);
-				print_result(name,pass);
-				if(!pass) output << "the same type !\r\n";
+#endif
+			AsyncReporter(const AsyncReporter&) = delete;
+			AsyncReporter& operator=(const AsyncReporter&) = delete;
+			~AsyncReporter(){
+				flush();
+				consumer.remove(this);
 			}
+			void started(Name) override {
+				push(header, "", 0);
+			}
+			void assertion(Name name, bool pass) override {
+				if(name.size()<=text_size) push(pass ? passed_line : failed_line, name.data(), name.size());
+				else{
+					push_text(fragment, "\ttest ", 6);
+					push_text(fragment, name.data(), name.size());
+					push_text(fragment, pass ? " passed.\r\n" : " failed ", pass ? 10 : 8);
+				}
+			}
+			void message(Name text) override {
+				push_text(message_line, text.data(), text.size());
+			}
+			void ended(int passed, int failed, double time) override {
+				char data[sizeof(int)*2+sizeof(double)];
+				int counters[2] = { passed, failed };
+				std::memcpy(data, counters, sizeof(counters));
+				std::memcpy(data+sizeof(counters), &time, sizeof(time));
+				push(resume, data, sizeof(data));
+			}
+			void flush() override {
+				if(pending()) consumer.flush(this);
+			}
+	};
+
+	/**
+	 * Reporter which appends the results to a compact binary log, to be converted offline
+	 * (see test_log_convert.cpp) into JUnit XML, JSON Lines or a summary.
+	 * The log is a flat sequence of records which can be memory-mapped : a tag byte followed by
+	 * unsigned LEB128 varints. Names are interned : each one is written once per session,
+	 * assertions only refer to its id.
+	 * A binary reporter is not thread-safe : tests which share it must not run concurrently.
+	*/
+	class BinaryReporter : public Reporter
+	{
+		public:
+		/**
+		 * magic bytes at the beginning of a log
+		*/
+			static const char* magic() { return "TSTLOG1\n"; }
+		/**
+		 * tags of records
+		*/
+			enum Tag : unsigned char
+			{
+				session = 'S', // varint : system time in ns since the epoch. Names interned before are forgotten
+				string = 'N', // varint id, varint size, bytes : interns a name
+				begin = 'B', // varint id of the test name
+				pass = 'P', // varint id of the assertion name, varint ns since the previous record of the test
+				fail = 'F', // varint id of the assertion name, varint ns since the previous record of the test
+				text = 'M', // varint size, bytes : a message
+				end = 'E' // varint passed, varint failed, varint duration of the test in ns
+			};
+		private:
+			std::FILE* file;
+			std::vector<char> buffer;
+			// interned names, with a cache on the address of the characters (names are mostly literals)
+			std::unordered_map<std::string, unsigned long long> ids;
+			struct Cached
+			{
+				const char* data;
+				std::size_t size;
+				unsigned long long id;
+				std::string copy;
+			};
+			std::vector<Cached> cache;
+			unsigned long long mark; // ticks of the previous record
+
+			void put(unsigned char byte){
+				buffer.push_back((char)byte);
+			}
+			void put(unsigned long long value){
+				while(value>=0x80){
+					buffer.push_back((char)((value&0x7f)|0x80));
+					value >>= 7;
+				}
+				buffer.push_back((char)value);
+			}
+			void put(const char* data, std::size_t size){
+				put((unsigned long long)size);
+				buffer.insert(buffer.end(), data, data+size);
+			}
+			void write(){
+				if(!buffer.empty()) std::fwrite(buffer.data(), 1, buffer.size(), file);
+				buffer.clear();
+			}
+			unsigned long long intern(Name name){
+				Cached& slot = cache[(reinterpret_cast<std::size_t>(name.data())>>3)%cache.size()];
+				if(slot.data==name.data() && slot.size==name.size() && std::memcmp(slot.copy.data(), name.data(), name.size())==0)
+					return slot.id;
+				std::string key = name.str();
+				auto found = ids.find(key);
+				unsigned long long id;
+				if(found!=ids.end()) id = found->second;
+				else{
+					id = ids.size();
+					ids.emplace(key, id);
+					put((unsigned char)string);
+					put(id);
+					put(name.data(), name.size());
+				}
+				slot.data = name.data();
+				slot.size = name.size();
+				slot.id = id;
+				slot.copy = std::move(key);
+				return id;
+			}
+			unsigned long long elapsed(){
+				unsigned long long now = Clock::ticks();
+				unsigned long long ns = (unsigned long long)Clock::to_ns(now-mark);
+				mark = now;
+				return ns;
+			}
+		public:
+		/**
+		 * Opens the log (results are appended to it)
+		 * @param path the path of the log
+		 * @throws std::runtime_error if the log cannot be opened
+		*/
+			explicit BinaryReporter(const std::string& path) : file(std::fopen(path.c_str(), "ab")), cache(256), mark(0){
+				if(file==nullptr) throw std::runtime_error("tests::BinaryReporter : cannot open "+path);
+				buffer.reserve(1<<16);
+				std::fseek(file, 0, SEEK_END);
+				if(std::ftell(file)==0) buffer.insert(buffer.end(), magic(), magic()+8);
+				put((unsigned char)session);
+				put((unsigned long long)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch()).count());
+			}
+			~BinaryReporter(){
+				write();
+				std::fclose(file);
+			}
+			void started(Name test) override {
+				unsigned long long id = intern(test);
+				put((unsigned char)begin);
+				put(id);
+				mark = Clock::ticks();
+			}
+			void assertion(Name name, bool pass) override {
+				unsigned long long id = intern(name);
+				put((unsigned char)(pass ? Tag::pass : Tag::fail));
+				put(id);
+				put(elapsed());
+				if(buffer.size() >= (1<<16)) write();
+			}
+			void message(Name text) override {
+				put((unsigned char)Tag::text);
+				put(text.data(), text.size());
+			}
+			void ended(int passed, int failed, double time) override {
+				put((unsigned char)end);
+				put((unsigned long long)passed);
+				put((unsigned long long)failed);
+				put((unsigned long long)(time*1000000.0));
+			}
+			void flush() override {
+				write();
+				std::fflush(file);
+			}
+	};
+
+	/**
+	 * Pool of threads which executes a fixed set of tasks with work-stealing :
+	 * each worker owns a deque of tasks, pops from its back and, when it is empty,
+	 * steals from the front of the other workers' deques.
+	 * Tasks are identified by their index in [0, count).
+	*/
+	class WorkStealingPool
+	{
+		private:
+			struct Queue
+			{
+				std::mutex lock;
+				std::deque<std::size_t> tasks;
+			};
+			unsigned workers;
+
+			static bool pop(Queue& queue, std::size_t& task)
+			{
+				std::lock_guard<std::mutex> guard(queue.lock);
+				if(queue.tasks.empty()) return false;
+				task = queue.tasks.back();
+				queue.tasks.pop_back();
+				return true;
+			}
+			static bool steal(Queue& queue, std::size_t& task)
+			{
+				std::lock_guard<std::mutex> guard(queue.lock);
+				if(queue.tasks.empty()) return false;
+				task = queue.tasks.front();
+				queue.tasks.pop_front();
+				return true;
+			}
+		public:
+		/**
+		 * @param workers number of threads (default : the number of cores of the machine)
+		*/
+			explicit WorkStealingPool(unsigned workers=0) : workers(workers){
+				if(this->workers==0) this->workers = std::thread::hardware_concurrency();
+				if(this->workers==0) this->workers = 1;
+			}
+		/**
+		 * @returns the number of threads of the pool
+		*/
+			unsigned size() const { return workers; }
+		/**
+		 * Executes task(i) for every i in [0, count) and waits for all of them.
+		 * Tasks are dealt round-robin to the workers in order, so each worker starts with the first ones.
+		 * @param count the number of tasks
+		 * @param task a functionnal object called with the index of the task and the index of the worker
+		 * @tparam function the functionnal type
+		*/
+			template <typename function>
+			void run(std::size_t count, function task)
+			{
+				unsigned threads = (unsigned)std::min<std::size_t>(workers, count);
+				if(threads<=1){
+					for(std::size_t i=0;i<count;i++) task(i,0u);
+					return;
+				}
+				std::vector<std::unique_ptr<Queue>> queues;
+				for(unsigned w=0;w<threads;w++) queues.emplace_back(new Queue());
+				// the back of each deque is popped first : push in reverse order to keep the order of tasks
+				for(std::size_t i=count;i-->0;)
+					queues[i%threads]->tasks.push_back(i);
+
+				auto work = [&](unsigned self){
+					std::size_t current;
+					for(;;){
+						if(pop(*queues[self],current)){
+							task(current,self);
+							continue;
+						}
+						bool stolen=false;
+						for(unsigned k=1;k<threads && !stolen;k++)
+							stolen = steal(*queues[(self+k)%threads],current);
+						if(!stolen) return; // no task is ever added : every queue is empty
+						task(current,self);
+					}
+				};
+				std::vector<std::thread> pool;
+				for(unsigned w=1;w<threads;w++) pool.emplace_back(work,w);
+				work(0);
+				for(auto& t : pool) t.join();
+			}
+	};
+
+	/**
+	 * Fast pseudo-random generator (xoshiro256**), seeded with splitmix64.
+	 * The same seed always gives the same sequence : property tests are replayed from their seed.
+	*/
+	class Random
+	{
+		private:
+			std::uint64_t state[4];
+			static std::uint64_t rotl(std::uint64_t x, int k) { return (x<<k)|(x>>(64-k)); }
+		public:
+		/**
+		 * Scrambles a value and advances it (splitmix64)
+		 * @param x the value, which is advanced
+		 * @returns the scrambled value
+		*/
+			static std::uint64_t mix(std::uint64_t& x){
+				std::uint64_t z = (x += 0x9E3779B97F4A7C15ULL);
+				z = (z ^ (z>>30)) * 0xBF58476D1CE4E5B9ULL;
+				z = (z ^ (z>>27)) * 0x94D049BB133111EBULL;
+				return z ^ (z>>31);
+			}
+			explicit Random(std::uint64_t seed=0){
+				this->seed(seed);
+			}
+			void seed(std::uint64_t seed){
+				for(int i=0;i<4;i++) state[i] = mix(seed);
+			}
+		/**
+		 * @returns 64 random bits
+		*/
+			std::uint64_t next(){
+				std::uint64_t result = rotl(state[1]*5, 7)*9;
+				std::uint64_t t = state[1]<<17;
+				state[2] ^= state[0];
+				state[3] ^= state[1];
+				state[1] ^= state[2];
+				state[0] ^= state[3];
+				state[2] ^= t;
+				state[3] = rotl(state[3], 45);
+				return result;
+			}
+		/**
+		 * @returns a random number in [0, bound), or 64 random bits if bound is 0
+		*/
+			std::uint64_t below(std::uint64_t bound){
+				if(bound==0) return next();
+#if defined(__SIZEOF_INT128__)
+				return (std::uint64_t)(((unsigned __int128)next()*bound)>>64);
+#else
+				return next()%bound;
+#endif
+			}
+		/**
+		 * @returns a random number in [0, 1)
+		*/
+			double unit(){
+				return (next()>>11)*(1.0/9007199254740992.0);
+			}
+		/**
+		 * @returns true once in n calls, on average
+		*/
+			bool one_in(std::uint64_t n){
+				return below(n)==0;
+			}
+	};
+
+	/**
+	 * Streaming 64 bits hash (XXH64) : update() may be called many times, digest() gives the hash of all the data
+	*/
+	class Hash64
+	{
+		private:
+			static const std::uint64_t p1 = 11400714785074694791ULL;
+			static const std::uint64_t p2 = 14029467366897019727ULL;
+			static const std::uint64_t p3 = 1609587929392839161ULL;
+			static const std::uint64_t p4 = 9650029242287828579ULL;
+			static const std::uint64_t p5 = 2870177450012600261ULL;
+			std::uint64_t lanes[4];
+			std::uint64_t seed;
+			std::uint64_t total;
+			unsigned char buffer[32];
+			std::size_t buffered;
+
+			static std::uint64_t rotl(std::uint64_t x, int k) { return (x<<k)|(x>>(64-k)); }
+			static std::uint64_t read64(const unsigned char* p) { std::uint64_t v; std::memcpy(&v, p, 8); return v; }
+			static std::uint32_t read32(const unsigned char* p) { std::uint32_t v; std::memcpy(&v, p, 4); return v; }
+			static std::uint64_t round(std::uint64_t lane, std::uint64_t input){
+				lane += input*p2;
+				return rotl(lane, 31)*p1;
+			}
+			static std::uint64_t merge(std::uint64_t hash, std::uint64_t lane){
+				hash ^= round(0, lane);
+				return hash*p1+p4;
+			}
+			void stripe(const unsigned char* p){
+				lanes[0] = round(lanes[0], read64(p));
+				lanes[1] = round(lanes[1], read64(p+8));
+				lanes[2] = round(lanes[2], read64(p+16));
+				lanes[3] = round(lanes[3], read64(p+24));
+			}
+		public:
+			explicit Hash64(std::uint64_t seed=0) : seed(seed), total(0), buffered(0){
+				lanes[0] = seed+p1+p2;
+				lanes[1] = seed+p2;
+				lanes[2] = seed;
+				lanes[3] = seed-p1;
+			}
+		/**
+		 * Adds data to the hash
+		 * @param data the data
+		 * @param size the size of the data, in bytes
+		 * @returns this hash
+		*/
+			Hash64& update(const void* data, std::size_t size){
+				const unsigned char* p = static_cast<const unsigned char*>(data);
+				total += size;
+				if(buffered>0){
+					std::size_t n = std::min(size, 32-buffered);
+					std::memcpy(buffer+buffered, p, n);
+					buffered += n;
+					p += n;
+					size -= n;
+					if(buffered<32) return *this;
+					stripe(buffer);
+					buffered = 0;
+				}
+				for(;size>=32;p+=32,size-=32) stripe(p);
+				if(size>0) std::memcpy(buffer, p, size);
+				buffered = size;
+				return *this;
+			}
+			Hash64& update(const std::string& text){
+				return update(text.data(), text.size());
+			}
+			Hash64& update(std::uint64_t value){
+				return update(&value, sizeof(value));
+			}
+		/**
+		 * @returns the hash of the data added so far
+		*/
+			std::uint64_t digest() const {
+				std::uint64_t hash;
+				if(total>=32){
+					hash = rotl(lanes[0],1)+rotl(lanes[1],7)+rotl(lanes[2],12)+rotl(lanes[3],18);
+					for(int i=0;i<4;i++) hash = merge(hash, lanes[i]);
+				}
+				else hash = seed+p5;
+				hash += total;
+				const unsigned char* p = buffer;
+				std::size_t size = buffered;
+				for(;size>=8;p+=8,size-=8) hash = rotl(hash ^ round(0, read64(p)), 27)*p1+p4;
+				if(size>=4){
+					hash = rotl(hash ^ (read32(p)*p1), 23)*p2+p3;
+					p += 4;
+					size -= 4;
+				}
+				for(;size>0;p++,size--) hash = rotl(hash ^ (*p*p5), 11)*p1;
+				hash ^= hash>>33;
+				hash *= p2;
+				hash ^= hash>>29;
+				hash *= p3;
+				hash ^= hash>>32;
+				return hash;
+			}
+		/**
+		 * @returns the hash of some data
+		*/
+			static std::uint64_t of(const void* data, std::size_t size, std::uint64_t seed=0){
+				return Hash64(seed).update(data, size).digest();
+			}
+	};
+
+	/**
+	 * Generators of values for property tests (see Test::for_all).
+	 * A generator has a value_type, a function generate(Random&, value_type&) which overwrites a value
+	 * (reusing its memory), and a function shrink(const value_type&, std::vector<value_type>&) which
+	 * appends simpler values, the simplest first.
+	*/
+	namespace gen
+	{
+		/**
+		 * Integers in [lo, hi] (default : every value of T), with the bounds, 0, 1 and -1 often drawn.
+		 * They shrink toward 0 (or the bound nearest to 0).
+		*/
+		template <typename T>
+		class integer
+		{
+			private:
+				typedef typename std::make_unsigned<T>::type U;
+				T lo;
+				T hi;
+				T target() const { return T(0)<lo ? lo : hi<T(0) ? hi : T(0); }
+			public:
+				typedef T value_type;
+				integer(T lo=std::numeric_limits<T>::min(), T hi=std::numeric_limits<T>::max()) : lo(lo), hi(hi){}
+				void generate(Random& random, T& value) const {
+					if(random.one_in(16)){
+						const T edges[5] = { lo, hi, target(), T(1), T(-1) };
+						value = edges[random.below(5)];
+						if(value<lo || hi<value) value = lo;
+						return;
+					}
+					value = T(U(lo) + U(random.below(std::uint64_t(U(U(hi)-U(lo)))+1)));
+				}
+				void shrink(const T& value, std::vector<T>& candidates) const {
+					T to = target();
+					if(value==to) return;
+					bool up = value<to;
+					U distance = up ? U(U(to)-U(value)) : U(U(value)-U(to));
+					candidates.push_back(to);
+					// closer and closer to the value : to + d/2, to + 3d/4... value -/+ 1
+					for(U step=distance/2;step>0;step/=2){
+						T candidate = up ? T(U(value)+step) : T(U(value)-step);
+						if(candidate!=candidates.back()) candidates.push_back(candidate);
+					}
+				}
+		};
+
+		/**
+		 * Floating point numbers in [lo, hi] (default : [-1e6, 1e6]), with the bounds, 0, 1 and -1 often drawn.
+		 * They shrink toward 0, integers and halves.
+		*/
+		template <typename T>
+		class real
+		{
+			private:
+				T lo;
+				T hi;
+				T target() const { return T(0)<lo ? lo : hi<T(0) ? hi : T(0); }
+			public:
+				typedef T value_type;
+				real(T lo=T(-1e6), T hi=T(1e6)) : lo(lo), hi(hi){}
+				void generate(Random& random, T& value) const {
+					if(random.one_in(16)){
+						const T edges[5] = { lo, hi, target(), T(1), T(-1) };
+						value = edges[random.below(5)];
+						if(value<lo || hi<value) value = lo;
+						return;
+					}
+					value = lo + T(random.unit())*(hi-lo);
+				}
+				void shrink(const T& value, std::vector<T>& candidates) const {
+					T to = target();
+					if(value==to || value!=value) return;
+					candidates.push_back(to);
+					T truncated = std::trunc(value);
+					if(truncated!=value && truncated>=lo && truncated<=hi) candidates.push_back(truncated);
+					T half = to + (value-to)/2;
+					if(half!=value && half!=to) candidates.push_back(half);
+				}
+		};
+
+		/**
+		 * Booleans, which shrink toward false
+		*/
+		class boolean
+		{
+			public:
+				typedef bool value_type;
+				void generate(Random& random, bool& value) const { value = (random.next()>>63)!=0; }
+				void shrink(const bool& value, std::vector<bool>& candidates) const {
+					if(value) candidates.push_back(false);
+				}
+		};
+
+		/**
+		 * Strings of at most max_size characters in [lo, hi] (default : printable characters).
+		 * They shrink by removing characters and replacing them with the first one of the range.
+		*/
+		class string
+		{
+			private:
+				std::size_t max_size;
+				char lo;
+				char hi;
+			public:
+				typedef std::string value_type;
+				string(std::size_t max_size=32, char lo=' ', char hi='~') : max_size(max_size), lo(lo), hi(hi){}
+				void generate(Random& random, std::string& value) const {
+					std::size_t size = random.one_in(16) ? 0 : (std::size_t)random.below(max_size+1);
+					value.resize(size);
+					std::uint64_t range = std::uint64_t((unsigned char)hi-(unsigned char)lo)+1;
+					for(std::size_t i=0;i<size;i++) value[i] = char((unsigned char)lo + random.below(range));
+				}
+				void shrink(const std::string& value, std::vector<std::string>& candidates) const {
+					if(value.empty()) return;
+					candidates.push_back(std::string());
+					if(value.size()>1){
+						candidates.push_back(value.substr(0, value.size()/2));
+						candidates.push_back(value.substr(value.size()/2));
+					}
+					for(std::size_t i=0;i<value.size();i++)
+						candidates.push_back(value.substr(0,i)+value.substr(i+1));
+					for(std::size_t i=0;i<value.size();i++)
+						if(value[i]!=lo){
+							candidates.push_back(value);
+							candidates.back()[i] = lo;
+						}
+				}
+		};
+
+		/**
+		 * Vectors of at most max_size elements made by another generator.
+		 * They shrink by removing elements, then by shrinking each element.
+		 * @tparam G the generator of elements
+		*/
+		template <typename G>
+		class vector
+		{
+			private:
+				G element;
+				std::size_t max_size;
+				template <typename V>
+				void generate(Random& random, V& value, std::size_t i) const { element.generate(random, value[i]); }
+				// std::vector<bool> has no references to its elements
+				void generate(Random& random, std::vector<bool>& value, std::size_t i) const {
+					bool item;
+					element.generate(random, item);
+					value[i] = item;
+				}
+			public:
+				typedef typename G::value_type element_type;
+				typedef std::vector<element_type> value_type;
+				vector(G element=G(), std::size_t max_size=32) : element(element), max_size(max_size){}
+				void generate(Random& random, value_type& value) const {
+					std::size_t size = random.one_in(16) ? 0 : (std::size_t)random.below(max_size+1);
+					value.resize(size);
+					for(std::size_t i=0;i<size;i++) generate(random, value, i);
+				}
+				void shrink(const value_type& value, std::vector<value_type>& candidates) const {
+					if(value.empty()) return;
+					candidates.push_back(value_type());
+					if(value.size()>1){
+						candidates.push_back(value_type(value.begin(), value.begin()+value.size()/2));
+						candidates.push_back(value_type(value.begin()+value.size()/2, value.end()));
+					}
+					for(std::size_t i=0;i<value.size();i++){
+						candidates.push_back(value);
+						candidates.back().erase(candidates.back().begin()+i);
+					}
+					std::vector<element_type> simpler;
+					for(std::size_t i=0;i<value.size();i++){
+						simpler.clear();
+						element.shrink(value[i], simpler);
+						for(std::size_t j=0;j<simpler.size();j++){
+							candidates.push_back(value);
+							candidates.back()[i] = simpler[j];
+						}
+					}
+				}
+		};
+	}
+
+	/**
+	 * @returns the name of the file replayed by replay_corpus, or nullptr
+	*/
+	inline const char*& fuzzed_input(){
+		static const char* name = nullptr;
+		return name;
+	}
+
+	/**
+	 * Replays a corpus through a fuzz target without instrumentation : each argument is a file, or a
+	 * directory whose files are all replayed (arguments starting with '-' are options of libFuzzer, ignored).
+	 * The number of inputs and the time taken are written on the standard error.
+	 * @param argc the number of arguments of the program
+	 * @param argv the arguments of the program
+	 * @param target the fuzz target (LLVMFuzzerTestOneInput)
+	 * @returns 0, or 1 if a file can't be read
+	*/
+	inline int replay_corpus(int argc, char** argv, int (*target)(const std::uint8_t*, std::size_t)){
+		std::vector<std::string> files;
+		for(int i=1;i<argc;i++){
+			if(argv[i][0]=='-') continue;
+#if defined(__unix__) || defined(__APPLE__)
+			struct stat info;
+			if(stat(argv[i], &info)==0 && S_ISDIR(info.st_mode)){
+				DIR* directory = opendir(argv[i]);
+				if(directory==nullptr) continue;
+				while(struct dirent* entry = readdir(directory)){
+					std::string path = std::string(argv[i])+"/"+entry->d_name;
+					if(stat(path.c_str(), &info)==0 && S_ISREG(info.st_mode)) files.push_back(path);
+				}
+				closedir(directory);
+				continue;
+			}
+#endif
+			files.push_back(argv[i]);
+		}
+		std::sort(files.begin(), files.end());
+		std::vector<std::uint8_t> buffer; // reused : its capacity grows to the biggest input
+		unsigned long long bytes = 0;
+		int result = 0;
+		Chrono chrono;
+		chrono.start();
+		for(std::size_t i=0;i<files.size();i++){
+			std::FILE* file = std::fopen(files[i].c_str(), "rb");
+			if(file==nullptr){
+				std::cerr << "can't read " << files[i] << "\r\n";
+				result = 1;
+				continue;
+			}
+			std::size_t size = 0;
+			for(;;){
+				if(buffer.size()<size+65536) buffer.resize(size+65536);
+				std::size_t read = std::fread(buffer.data()+size, 1, buffer.size()-size, file);
+				size += read;
+				if(read==0) break;
+			}
+			std::fclose(file);
+			fuzzed_input() = files[i].c_str();
+			target(buffer.data(), size);
+			bytes += size;
+		}
+		fuzzed_input() = nullptr;
+		chrono.stop();
+		std::cerr << "Replayed " << files.size() << " inputs (" << bytes << " bytes) in " << chrono.time() << " ms.\r\n";
+		return result;
+	}
+
+	/**
+	 * @returns a name which can be the name of a file : the characters other than letters, digits, '-' and '.' become '_'
+	*/
+	inline std::string file_name(const std::string& name){
+		std::string result;
+		for(char c : name) result += std::isalnum((unsigned char)c) || c=='-' || c=='.' ? c : '_';
+		return result;
+	}
+
+	/**
+	 * On-disk cache of test results : a test whose binary and input files have not changed since it passed
+	 * is not run again, its result is read from the cache (see Test::set_cache and Suite::set_cache).
+	 * The cache is a text file, loaded by the constructor and saved by save() or the destructor.
+	*/
+	class ResultCache
+	{
+		public:
+		/**
+		 * The result of the last run of a test
+		*/
+			typedef CachedResult Result;
+		private:
+			std::string path;
+			mutable std::mutex lock;
+			std::unordered_map<std::string, Result> results;
+			std::unordered_map<std::string, const void*> owners; // the test which recorded each result during this run
+			bool changed;
+
+#if defined(__linux__)
+			// hashes the sections of an ELF image which are loaded in memory : code and data, not debug informations
+			template <typename Header, typename Section>
+			static bool hash_sections(const unsigned char* image, std::size_t size, Hash64& hash){
+				if(size<sizeof(Header)) return false;
+				Header header;
+				std::memcpy(&header, image, sizeof(header));
+				if(header.e_shoff==0 || header.e_shentsize!=sizeof(Section) || header.e_shoff+header.e_shnum*sizeof(Section)>size) return false;
+				for(unsigned i=0;i<header.e_shnum;i++){
+					Section section;
+					std::memcpy(&section, image+header.e_shoff+i*sizeof(Section), sizeof(section));
+					if(!(section.sh_flags & SHF_ALLOC) || section.sh_type==SHT_NOBITS) continue;
+					if(section.sh_offset+section.sh_size>size) return false;
+					hash.update(image+section.sh_offset, (std::size_t)section.sh_size);
+				}
+				return true;
+			}
+#endif
+		public:
+		/**
+		 * Loads a cache
+		 * @param path the file of the cache (created by save() if it does not exist)
+		*/
+			explicit ResultCache(const std::string& path) : path(path), changed(false){
+				std::ifstream file(path.c_str());
+				std::string line;
+				while(std::getline(file, line)){
+					std::istringstream fields(line);
+					Result result;
+					std::string name;
+					fields >> std::hex >> result.key >> std::dec >> result.passed >> result.failed >> result.time;
+					fields.get();
+					if(fields && std::getline(fields, name) && !name.empty()) results[name] = result;
+				}
+			}
+			~ResultCache(){
+				save();
+			}
+		/**
+		 * Finds the last result of a test
+		 * @param name the name of the test
+		 * @param result the result found
+		 * @returns true if the test has a result
+		*/
+			bool find(const std::string& name, Result& result) const {
+				std::lock_guard<std::mutex> guard(lock);
+				std::unordered_map<std::string, Result>::const_iterator found = results.find(name);
+				if(found==results.end()) return false;
+				result = found->second;
+				return true;
+			}
+		/**
+		 * Records the result of a test. When two tests record a result under the same name, the result
+		 * gets a null key, so it is never taken for the result of one of them.
+		 * @param name the name of the test
+		 * @param result the result
+		 * @param owner the test which records it (nullptr : not checked)
+		*/
+			void record(const std::string& name, const Result& result, const void* owner=nullptr){
+				std::lock_guard<std::mutex> guard(lock);
+				Result& recorded = results[name];
+				const void*& first = owners[name];
+				bool shared = owner!=nullptr && first!=nullptr && first!=owner;
+				if(first==nullptr) first = owner;
+				recorded = result;
+				if(shared) recorded.key = 0;
+				changed = true;
+			}
+		/**
+		 * Writes the cache to its file, if it has changed
+		*/
+			void save(){
+				std::lock_guard<std::mutex> guard(lock);
+				if(!changed) return;
+				std::string temporary = path+".tmp";
+				{
+					std::ofstream file(temporary.c_str(), std::ios::trunc);
+					file.precision(17);
+					for(const auto& result : results)
+						file << std::hex << result.second.key << std::dec << ' ' << result.second.passed << ' '
+							<< result.second.failed << ' ' << result.second.time << ' ' << result.first << '\n';
+					if(!file) return;
+				}
+				if(std::rename(temporary.c_str(), path.c_str())==0) changed = false;
+			}
+		/**
+		 * @returns the hash of the running program : of the sections of its ELF image loaded in memory
+		 * (code and data, so a rebuild which only changes debug informations keeps it), or of the whole file.
+		 * It is 0 when the program can't be read : then no result is taken from a cache.
+		*/
+			static std::uint64_t binary_hash(){
+				static const std::uint64_t hash = []() -> std::uint64_t {
+#if defined(__linux__)
+					int fd = open("/proc/self/exe", O_RDONLY);
+					if(fd<0) return 0;
+					struct stat info;
+					if(fstat(fd, &info)!=0 || info.st_size==0){
+						close(fd);
+						return 0;
+					}
+					std::size_t size = (std::size_t)info.st_size;
+					void* map = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+					close(fd);
+					if(map==MAP_FAILED) return 0;
+					const unsigned char* image = static_cast<const unsigned char*>(map);
+					Hash64 sections;
+					bool elf = size>EI_CLASS && std::memcmp(image, ELFMAG, SELFMAG)==0 && (image[EI_CLASS]==ELFCLASS64
+						? hash_sections<Elf64_Ehdr, Elf64_Shdr>(image, size, sections)
+						: hash_sections<Elf32_Ehdr, Elf32_Shdr>(image, size, sections));
+					std::uint64_t result = elf ? sections.digest() : Hash64::of(image, size);
+					munmap(map, size);
+					return result==0 ? 1 : result;
+#else
+					return 0;
+#endif
+				}();
+				return hash;
+			}
+		/**
+		 * @returns the hash of the content of a file, or 0 if it can't be read
+		*/
+			static std::uint64_t file_hash(const std::string& path){
+				std::FILE* file = std::fopen(path.c_str(), "rb");
+				if(file==nullptr) return 0;
+				Hash64 hash;
+				char buffer[65536];
+				std::size_t read;
+				while((read=std::fread(buffer, 1, sizeof(buffer), file))>0) hash.update(buffer, read);
+				std::fclose(file);
+				return hash.digest();
+			}
+	};
+
+	/**
+	 * Stream buffer which hashes what is written (see Hash64), and may copy it to another stream
+	*/
+	class HashingBuffer : public std::streambuf
+	{
+		private:
+			Hash64 hash;
+			std::uint64_t length;
+			std::ostream* copy;
+			char buffer[65536];
+
+			void consume(const char* data, std::size_t size){
+				hash.update(data, size);
+				if(copy!=nullptr) copy->write(data, size);
+				length += size;
+			}
+			void drain(){
+				consume(pbase(), pptr()-pbase());
+				setp(buffer, buffer+sizeof(buffer));
+			}
+		protected:
+			int overflow(int c) override {
+				drain();
+				if(c!=traits_type::eof()){
+					*pptr() = (char)c;
+					pbump(1);
+				}
+				return traits_type::not_eof(c);
+			}
+			std::streamsize xsputn(const char* data, std::streamsize size) override {
+				if(size<=epptr()-pptr()){
+					std::memcpy(pptr(), data, (std::size_t)size);
+					pbump((int)size);
+				}
+				else{
+					drain();
+					consume(data, (std::size_t)size);
+				}
+				return size;
+			}
+			int sync() override {
+				drain();
+				return 0;
+			}
+		public:
+		/**
+		 * @param copy the stream which receives a copy of the data (nullptr : no copy)
+		*/
+			explicit HashingBuffer(std::ostream* copy=nullptr) : length(0), copy(copy){
+				setp(buffer, buffer+sizeof(buffer));
+			}
+		/**
+		 * @returns the hash of the data written so far
+		*/
+			std::uint64_t digest(){
+				drain();
+				return hash.digest();
+			}
+		/**
+		 * @returns the size of the data written so far, in bytes
+		*/
+			std::uint64_t size(){
+				drain();
+				return length;
+			}
+	};
+
+	/**
+	 * Store of the snapshots of the outputs of tests (see Test::assert_snapshot) : only the hash and the size of
+	 * each output are kept, in the file "snapshots" of a directory. In update mode, the outputs are recorded,
+	 * with a full copy (name.snapshot) ; in compare mode, an output which differs is written to name.actual, for diffing.
+	 * The mode may be read in the environment (TESTS_SNAPSHOTS=update) or in the arguments of the program
+	 * (--snapshots=update).
+	*/
+	class SnapshotStore
+	{
+		public:
+			enum Mode
+			{
+				compare,
+				update
+			};
+		/**
+		 * The snapshot of an output
+		*/
+			struct Digest
+			{
+				std::uint64_t hash;
+				std::uint64_t size; // bytes
+			};
+		private:
+			std::string directory;
+			Mode current;
+			mutable std::mutex lock;
+			std::unordered_map<std::string, Digest> digests;
+			bool changed;
+		public:
+		/**
+		 * Loads a store
+		 * @param directory the directory of the store (created if needed)
+		 * @param mode compare or update the snapshots (default : compare, update if TESTS_SNAPSHOTS is "update")
+		*/
+			explicit SnapshotStore(const std::string& directory, Mode mode=compare) : directory(directory), current(mode), changed(false){
+				const char* variable = std::getenv("TESTS_SNAPSHOTS");
+				if(variable!=nullptr && std::strcmp(variable, "update")==0) current = update;
+#if defined(__unix__) || defined(__APPLE__)
+				mkdir(directory.c_str(), 0777);
+#endif
+				std::ifstream file((directory+"/snapshots").c_str());
+				std::string line;
+				while(std::getline(file, line)){
+					std::istringstream fields(line);
+					Digest digest;
+					std::string name;
+					fields >> std::hex >> digest.hash >> std::dec >> digest.size;
+					fields.get();
+					if(fields && std::getline(fields, name) && !name.empty()) digests[name] = digest;
+				}
+			}
+			~SnapshotStore(){
+				save();
+			}
+		/**
+		 * Reads the mode in the arguments of the program : --snapshots=update or --snapshots=compare
+		 * @param argc the number of arguments
+		 * @param argv the arguments
+		*/
+			void parse_arguments(int argc, char** argv){
+				for(int i=1;i<argc;i++){
+					if(std::strcmp(argv[i], "--snapshots=update")==0) current = update;
+					else if(std::strcmp(argv[i], "--snapshots=compare")==0) current = compare;
+				}
+			}
+		/**
+		 * @returns the mode of the store
+		*/
+			Mode mode() const { return current; }
+		/**
+		 * @param name the name of a snapshot
+		 * @param extension the extension of the file : ".snapshot" or ".actual"
+		 * @returns the path of a copy of the output
+		*/
+			std::string path(const std::string& name, const char* extension) const {
+				return directory+"/"+file_name(name)+extension;
+			}
+		/**
+		 * Finds a snapshot
+		 * @param name the name of the snapshot
+		 * @param digest the snapshot found
+		 * @returns true if the snapshot exists
+		*/
+			bool find(const std::string& name, Digest& digest) const {
+				std::lock_guard<std::mutex> guard(lock);
+				std::unordered_map<std::string, Digest>::const_iterator found = digests.find(name);
+				if(found==digests.end()) return false;
+				digest = found->second;
+				return true;
+			}
+		/**
+		 * Records a snapshot
+		*/
+			void record(const std::string& name, const Digest& digest){
+				std::lock_guard<std::mutex> guard(lock);
+				digests[name] = digest;
+				changed = true;
+			}
+		/**
+		 * Writes the snapshots to the file of the store, if they have changed
+		*/
+			void save(){
+				std::lock_guard<std::mutex> guard(lock);
+				if(!changed) return;
+				std::string path = directory+"/snapshots", temporary = path+".tmp";
+				{
+					std::ofstream file(temporary.c_str(), std::ios::trunc);
+					for(const auto& digest : digests)
+						file << std::hex << digest.second.hash << std::dec << ' ' << digest.second.size << ' ' << digest.first << '\n';
+					if(!file) return;
+				}
+				if(std::rename(temporary.c_str(), path.c_str())==0) changed = false;
+			}
+	};
+
+	/**
+	 * Text of a field of a data file (see Test::for_each_csv) : it points into the mapped file, without a copy
+	*/
+	class Text
+	{
+		private:
+			const char* text;
+			std::size_t length;
+		public:
+			Text() : text(""), length(0){}
+			Text(const char* text) : text(text), length(std::strlen(text)){}
+			Text(const std::string& text) : text(text.data()), length(text.size()){}
+			Text(const char* text, std::size_t length) : text(text), length(length){}
+			const char* data() const { return text; }
+			std::size_t size() const { return length; }
+			bool empty() const { return length==0; }
+			std::string str() const { return std::string(text, length); }
+	};
+	inline bool operator==(const Text& a, const Text& b) { return a.size()==b.size() && std::memcmp(a.data(), b.data(), a.size())==0; }
+	inline bool operator!=(const Text& a, const Text& b) { return !(a==b); }
+	inline std::ostream& operator<<(std::ostream& output, const Text& text) { return output.write(text.data(), text.size()); }
+
+	/**
+	 * A file mapped in memory, read only (read in memory where mmap is not available)
+	*/
+	class MappedFile
+	{
+		private:
+			const char* bytes;
+			std::size_t length;
+			bool mapped;
+			std::vector<char> content;
+			MappedFile(const MappedFile&) = delete;
+			MappedFile& operator=(const MappedFile&) = delete;
+		public:
+		/**
+		 * Maps a file
+		 * @param path the path of the file (see valid())
+		*/
+			explicit MappedFile(const std::string& path) : bytes(nullptr), length(0), mapped(false){
+#if defined(__unix__) || defined(__APPLE__)
+				int fd = open(path.c_str(), O_RDONLY);
+				if(fd<0) return;
+				struct stat info;
+				if(fstat(fd, &info)==0 && info.st_size==0) bytes = "";
+				else if(fstat(fd, &info)==0){
+					void* map = mmap(nullptr, (std::size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+					if(map!=MAP_FAILED){
+						bytes = static_cast<const char*>(map);
+						length = (std::size_t)info.st_size;
+						mapped = true;
+						madvise(map, length, MADV_SEQUENTIAL);
+					}
+				}
+				close(fd);
+#else
+				std::ifstream file(path.c_str(), std::ios::binary);
+				if(!file) return;
+				content.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+				bytes = content.empty() ? "" : content.data();
+				length = content.size();
+#endif
+			}
+			~MappedFile(){
+#if defined(__unix__) || defined(__APPLE__)
+				if(mapped) munmap(const_cast<char*>(bytes), length);
+#endif
+			}
+		/**
+		 * @returns true if the file is read
+		*/
+			bool valid() const { return bytes!=nullptr; }
+			const char* data() const { return bytes; }
+			std::size_t size() const { return length; }
+		/**
+		 * Releases the pages of a part of the file which is not read any more : they are read again if needed
+		*/
+			void release(std::size_t offset, std::size_t size){
+#if defined(__unix__) || defined(__APPLE__)
+				if(!mapped) return;
+				std::size_t page = (std::size_t)sysconf(_SC_PAGESIZE);
+				std::size_t first = (offset+page-1)/page*page, last = (offset+size)/page*page;
+				if(first<last) madvise(const_cast<char*>(bytes)+first, last-first, MADV_DONTNEED);
+#else
+				(void)offset;
+				(void)size;
+#endif
+			}
+	};
+
+	// parsers of the fields of the CSV files : false when the text is not a value of the type
+	inline bool parse_field(const char* begin, const char* end, Text& value){
+		value = Text(begin, end-begin);
+		return true;
+	}
+	inline bool parse_field(const char* begin, const char* end, std::string& value){
+		value.assign(begin, end);
+		return true;
+	}
+	inline bool parse_field(const char* begin, const char* end, char& value){
+		if(end-begin!=1) return false;
+		value = *begin;
+		return true;
+	}
+	template <typename T>
+	typename std::enable_if<std::is_integral<T>::value, bool>::type parse_field(const char* begin, const char* end, T& value){
+		bool negative = begin<end && *begin=='-';
+		if(begin<end && (*begin=='-' || *begin=='+')) begin++;
+		if(begin==end || (negative && !std::is_signed<T>::value)) return false;
+		unsigned long long magnitude = 0;
+		const unsigned long long limit = negative ? (unsigned long long)std::numeric_limits<T>::max()+1 : (unsigned long long)std::numeric_limits<T>::max();
+		for(;begin<end;begin++){
+			unsigned digit = (unsigned)(*begin-'0');
+			if(digit>9 || magnitude>(limit-digit)/10) return false;
+			magnitude = magnitude*10+digit;
+		}
+		value = negative ? (T)(0-magnitude) : (T)magnitude;
+		return true;
+	}
+	template <typename T>
+	typename std::enable_if<std::is_floating_point<T>::value, bool>::type parse_field(const char* begin, const char* end, T& value){
+		char buffer[64]; // strtold needs a terminated text
+		if(begin==end || end-begin>=(std::ptrdiff_t)sizeof(buffer)) return false;
+		std::memcpy(buffer, begin, end-begin);
+		buffer[end-begin] = 0;
+		char* stop;
+		value = (T)std::strtold(buffer, &stop);
+		return stop==buffer+(end-begin);
+	}
+	/**
+	 * Parses the next field of a record
+	 * @param cursor the start of the field, moved to the next one (nullptr after the last field)
+	 * @returns false if there is no field left, or if it can't be parsed
+	*/
+	template <typename T>
+	bool parse_next(const char*& cursor, const char* end, char separator, T& value){
+		if(cursor==nullptr) return false;
+		const char* first = cursor;
+		while(first<end && (*first==' ' || *first=='\t')) first++;
+		// a field in double quotes may contain the separator : it ends after the first quote which is not doubled
+		const char* after = first;
+		if(first<end && *first=='"'){
+			const char* quote = first+1;
+			while((quote = static_cast<const char*>(std::memchr(quote, '"', end-quote)))!=nullptr && quote+1<end && quote[1]=='"') quote += 2;
+			if(quote!=nullptr) after = quote+1;
+		}
+		const char* stop = static_cast<const char*>(std::memchr(after, separator, end-after));
+		const char* last = stop==nullptr ? end : stop;
+		cursor = stop==nullptr ? nullptr : stop+1;
+		while(last>first && (last[-1]==' ' || last[-1]=='\t')) last--;
+		if(last-first>=2 && *first=='"' && last[-1]=='"'){
+			first++;
+			last--;
+		}
+		return parse_field(first, last, value);
+	}
+	/**
+	 * Parses a line of a CSV file
+	 * @param parsed the number of fields parsed
+	 * @returns true if the line has a right value for each field, and no other field
+	*/
+	template <typename values, std::size_t... I>
+	bool parse_record(const char* begin, const char* end, char separator, values& into, std::size_t& parsed, Indexes<I...>){
+		const char* cursor = begin;
+		bool right = true;
+		parsed = 0;
+		int expand[] = { 0, ((right = right && parse_next(cursor, end, separator, std::get<I>(into))), parsed += right ? 1 : 0, 0)... };
+		(void)expand;
+		return right && cursor==nullptr;
+	}
+	/**
+	 * Reads a record of a binary file : its fields follow each other, without padding
+	*/
+	template <typename values, std::size_t... I>
+	void read_record(const char* record, values& into, Indexes<I...>){
+		std::size_t offset = 0;
+		int expand[] = { 0, (std::memcpy(&std::get<I>(into), record+offset, sizeof(typename std::tuple_element<I,values>::type)),
+			offset += sizeof(typename std::tuple_element<I,values>::type), 0)... };
+		(void)expand;
+	}
+
+	/**
+	 * @returns the size of a record of a binary file : the sum of the sizes of its fields
+	*/
+	template <typename T>
+	constexpr std::size_t sum_of_sizes(){
+		static_assert(std::is_trivially_copyable<T>::value, "the fields of a binary file must be trivially copyable");
+		return sizeof(T);
+	}
+	template <typename T, typename U, typename... V>
+	constexpr std::size_t sum_of_sizes(){
+		return sum_of_sizes<T>()+sum_of_sizes<U, V...>();
+	}
+
+	/**
+	 * Members of the tests which need the heavy machinery : they are hidden from test_decl.h
+	*/
+	struct Test::Internals
+	{
+		struct AssertionTiming
+		{
+			unsigned long long count;
+			unsigned long long total; // ticks
+			unsigned long long max; // ticks
+		};
+		StreamReporter direct; // reporter of assertions called outside of run()
+		Chrono chrono;
+		WatchDog watchdog;
+		std::unordered_map<std::string, AssertionTiming> timings;
+		AllocationCounters allocations; // counted during the last run
+		AllocationCounters allocations_before; // counters of the thread when the run started
+		std::unique_ptr<Reporter> default_reporter; // of the runs of the test, when it has no reporter
+		long rss_before; // kilobytes
+		long rss_after;
+		CounterValues counters; // counted during the last run of test_code
+		Internals(std::ostream& output, unsigned long timeout) : direct(output), watchdog(timeout), allocations(), rss_before(0), rss_after(0){}
+	};
+
+	// functions of the tests : in the header-only mode, or compiled once by test.cpp
+#if !defined(TESTS_SEPARATE_COMPILATION) || defined(TESTS_IMPLEMENTATION)
+#if defined(__GNUC__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wattributes" // the cold functions stay out of line, even when they are inline
+#endif
+	TESTS_INLINE std::ostream& default_output() { return std::cout; }
+	TESTS_INLINE void print_integer(std::ostream& output, long long value) { output << value; }
+	TESTS_INLINE void print_integer(std::ostream& output, unsigned long long value) { output << value; }
+	TESTS_INLINE void print_real(std::ostream& output, long double value) { output << value; }
+	TESTS_INLINE void print_text(std::ostream& output, const char* text) { output << text; }
+	TESTS_INLINE void print_text(std::ostream& output, const std::string& text) { output << text; }
+	TESTS_INLINE void print_character(std::ostream& output, char value) { output << value; }
+	TESTS_INLINE void print_pointer(std::ostream& output, const void* pointer) { output << pointer; }
+
+	TESTS_INLINE Arena::~Arena(){
+		reset();
+		while(first!=nullptr){
+			Block* next = first->next;
+			::operator delete(first);
+			first = next;
+		}
+	}
+	TESTS_INLINE void* Arena::grow(std::size_t size, std::size_t alignment){
+		std::size_t needed = size+alignment;
+		if(current!=nullptr && current->next!=nullptr && current->next->size>=needed) current = current->next;
+		else{
+			std::size_t bytes = std::max(current!=nullptr ? current->size*2 : block_size, needed);
+			Block* block = static_cast<Block*>(::operator new(sizeof(Block)+bytes));
+			block->size = bytes;
+			if(current==nullptr){
+				block->next = first;
+				first = block;
+			}
+			else{
+				block->next = current->next;
+				current->next = block;
+			}
+			current = block;
+		}
+		position = data(current);
+		end = position+current->size;
+		return allocate(size, alignment);
+	}
+	TESTS_INLINE std::size_t Arena::capacity() const {
+		std::size_t bytes = 0;
+		for(Block* block=first;block!=nullptr;block=block->next) bytes += block->size;
+		return bytes;
+	}
+	TESTS_INLINE AllocationCounters& allocation_counters(){
+		static thread_local AllocationCounters counters;
+		return counters;
+	}
+	TESTS_INLINE bool& allocations_counted(){
+		static bool counted = false;
+		return counted;
+	}
+
+	// the arena of the calling thread, reused by the tests it runs
+	TESTS_INLINE Arena& thread_arena(){
+		static thread_local Arena arena;
+		return arena;
+	}
+
+	TESTS_INLINE void* Fixture::build(){
+		for(unsigned spins=0;;spins++){
+			void* built = value.load(std::memory_order_acquire);
+			if(built!=nullptr) return built;
+			bool expected = false;
+			if(building.compare_exchange_strong(expected, true)){
+				struct Release
+				{
+					std::atomic<bool>& flag;
+					~Release() { flag.store(false); }
+				} release = { building };
+				built = value.load(std::memory_order_acquire);
+				if(built==nullptr){
+					built = create();
+					if(built==nullptr) throw std::runtime_error("the factory of a fixture returned nullptr");
+					value.store(built, std::memory_order_release);
+				}
+				return built;
+			}
+			// another thread builds the value
+			if(spins<100) std::this_thread::yield();
+			else std::this_thread::sleep_for(std::chrono::microseconds(100));
+		}
+	}
+
+	TESTS_INLINE Test::Test(std::ostream& output, unsigned long timeout)
+		: failed(0),passed(0),static_passed(0),output(&output),reporter(nullptr),internals(new Internals(output, timeout)),current(&internals->direct),verbosity(all),
+		  timeout_delay(timeout),timing(false),mark(0),timed_out(false),
+		  property_cases(10000),property_seed(0),property_threads(0),data_threads(0),cores_shared(false),
+		  fuzzing(false),fuzz_failed(false),cache(nullptr),complexity_first(1024),complexity_last(1<<20),
+		  stress_rounds(10),stress_pinned(false),stress_seed(0),stress_perturbation(0.05),baseline(nullptr),perf_counters(false),snapshots(nullptr),memory(nullptr),rank(0){}
+	TESTS_INLINE Test::~Test(){
+		delete internals;
+	}
+	TESTS_INLINE void Test::run(){
+		execute(true);
+		to_cache(passed, failed, internals->chrono.time());
+	}
+	TESTS_INLINE double Test::time() { return internals->chrono.time(); }
+	TESTS_INLINE std::string Test::name() const {
+#if defined(TESTS_RTTI)
+		return demangle(typeid(*this).name());
+#else
+		return "test";
+#endif
+	}
+	TESTS_INLINE void Test::fuzz(const std::uint8_t* data, std::size_t size){
+		static StreamReporter errors(std::cerr);
+		Reporter* previous = current;
+		Verbosity level = verbosity;
+		// the assertions of an input are not counted : millions of inputs would overflow the counters
+		int passed_before = passed, failed_before = failed;
+		current = &errors;
+		verbosity = failures;
+		fuzzing = true;
+		try{
+			fuzz_code(data, size);
+		}
+		catch(...){
+			fail("*** exception occurs ***");
+		}
+		arena().reset();
+		if(fuzz_failed) fuzz_abort();
+		fuzzing = false;
+		passed = passed_before;
+		failed = failed_before;
+		verbosity = level;
+		current = previous;
+	}
+	TESTS_INLINE void Test::execute(bool guarded){
+		if(start_execute(guarded, nullptr)){
+			std::unique_ptr<PerfCounters> counters_of_thread(perf_counters ? new PerfCounters() : nullptr);
+			bool prepared = false;
+			try{
+				set_up();
+				prepared = true;
+				if(counters_of_thread) counters_of_thread->start();
+				test_code();
+				if(counters_of_thread) internals->counters = counters_of_thread->stop();
+			}
+			catch(const Timeout&){
+				if(counters_of_thread && prepared) internals->counters = counters_of_thread->stop();
+				timed_out=false;
+				fail("*** timeout ***");
+			}
+			catch(...){
+				if(counters_of_thread && prepared) internals->counters = counters_of_thread->stop();
+				if(guarded) internals->watchdog.cancel();
+				timed_out=false;
+				fail(prepared ? "*** exception occurs ***" : "*** exception occurs in set_up ***");
+			}
+			if(prepared){
+				try{
+					tear_down();
+				}
+				catch(...){
+					if(guarded) internals->watchdog.cancel();
+					timed_out=false;
+					fail("*** exception occurs in tear_down ***");
+				}
+			}
+			finish_execute(guarded);
+		}
+		end_execute();
+	}
+	TESTS_INLINE bool Test::start_execute(bool guarded, Arena* arena){
+		failed=0;
+		passed=0;
+		static_passed=0;
+		timed_out=false;
+		internals->timings.clear();
+		internals->allocations = AllocationCounters();
+		internals->counters = CounterValues();
+		ResultCache::Result cached;
+		bool skipped = cached_result(cached);
+		current = reporter;
+		if(current==nullptr){
+			// made by the first run, its ring is kept for the next ones
+			if(!internals->default_reporter) internals->default_reporter.reset(new AsyncReporter(*output));
+			current = internals->default_reporter.get();
+		}
+		print_header();
+		internals->chrono.start();
+		mark = Clock::ticks();
+		if(skipped){
+			passed = cached.passed;
+			std::ostringstream text;
+			text << "\tresult from the cache of a run in " << cached.time << " ms";
+			print_message(text.str());
+			return false;
+		}
+		AllocationCounters& counters = allocation_counters();
+		internals->allocations_before = counters;
+		counters.peak = counters.live;
+		internals->rss_before = max_rss();
+		memory = arena!=nullptr ? arena : &thread_arena();
+		if(guarded) internals->watchdog.start([this](){ timed_out=true; });
+		return true;
+	}
+	TESTS_INLINE void Test::finish_execute(bool guarded){
+		if(guarded) internals->watchdog.cancel();
+		memory->reset();
+		memory = nullptr;
+		internals->rss_after = max_rss();
+		AllocationCounters& counters = allocation_counters();
+		const AllocationCounters& start = internals->allocations_before;
+		AllocationCounters& allocations = internals->allocations;
+		allocations.count = counters.count-start.count;
+		allocations.bytes = counters.bytes-start.bytes;
+		allocations.live = counters.live-start.live;
+		allocations.peak = counters.peak-start.live;
+		if(start.peak>counters.peak) counters.peak = start.peak;
+	}
+	TESTS_INLINE void Test::end_execute(){
+		timed_out=false;
+		internals->chrono.stop();
+		print_resume();
+		current->flush();
+		current = &internals->direct;
+	}
+	TESTS_INLINE Arena& Test::arena(){
+		return memory!=nullptr ? *memory : thread_arena();
+	}
+	TESTS_INLINE void Test::print_header(){
+		current->started(name());
+	}
+	TESTS_INLINE std::string Test::stored_name() const {
+		return rank==0 ? name() : name()+"#"+std::to_string(rank+1);
+	}
+	TESTS_INLINE std::uint64_t Test::cache_key() const {
+		Hash64 hash;
+		hash.update(stored_name()).update(ResultCache::binary_hash());
+		for(const auto& path : inputs) hash.update(path).update(ResultCache::file_hash(path));
+		return hash.digest();
+	}
+	TESTS_INLINE bool Test::cached_result(CachedResult& result) const {
+		return cache!=nullptr && ResultCache::binary_hash()!=0 && cache->find(stored_name(), result)
+			&& result.failed==0 && result.key!=0 && result.key==cache_key();
+	}
+	TESTS_INLINE bool Test::failed_before() const {
+		ResultCache::Result result;
+		return cache!=nullptr && cache->find(stored_name(), result) && result.failed>0;
+	}
+	TESTS_INLINE void Test::to_cache(int passed, int failed, double time){
+		if(cache==nullptr) return;
+		ResultCache::Result result;
+		if(failed==0 && cached_result(result)) return;
+		result.key = cache_key();
+		result.passed = passed;
+		result.failed = failed;
+		result.time = time;
+		cache->record(stored_name(), result, this);
+	}
+	TESTS_INLINE void Test::print_resume(){
+		current->ended(passed, failed, internals->chrono.time());
+		if(static_passed>0){
+			std::ostringstream text;
+			text << "Compile-time tests : " << static_passed << " passed.";
+			current->message(text.str());
+		}
+		if(allocations_counted()){
+			const AllocationCounters& allocations = internals->allocations;
+			std::ostringstream text;
+			text << "Memory : " << allocations.count << " allocations of " << allocations.bytes << " bytes, peak of "
+				<< allocations.peak << " bytes, " << allocations.live << " bytes not freed. Maximum RSS is "
+				<< internals->rss_after << " KB (+" << internals->rss_after-internals->rss_before << " KB).";
+			current->message(text.str());
+		}
+		if(perf_counters){
+			if(internals->counters.any()) current->message("Counters : "+internals->counters.describe());
+			else current->message("Counters : not available (see perf_event_paranoid).");
+		}
+		if(timing) print_timings();
+	}
+	TESTS_INLINE void Test::print_timings(){
+		typedef std::pair<std::string, Internals::AssertionTiming> Entry;
+		std::vector<Entry> sorted(internals->timings.begin(), internals->timings.end());
+		std::sort(sorted.begin(), sorted.end(), [](const Entry& a, const Entry& b){
+			return a.second.total > b.second.total;
+		});
+		current->message(std::string("Assertion times (")+(Clock::uses_tsc()?"TSC":"steady clock")+") :");
+		for(auto& item : sorted){
+			std::ostringstream line;
+			line << "\t"<<(item.first.empty()?"(unnamed)":item.first)<<" : "<<item.second.count<<" calls, total "
+				<<Clock::to_ns(item.second.total)/1000000.0<<" ms, max "<<Clock::to_ns(item.second.max)/1000.0<<" us.";
+			current->message(line.str());
+		}
+	}
+	TESTS_INLINE void Test::time_assertion(Name name){
+		unsigned long long elapsed = Clock::ticks()-mark;
+		Internals::AssertionTiming& entry = internals->timings[name.str()];
+		entry.count++;
+		entry.total += elapsed;
+		entry.max = std::max(entry.max, elapsed);
+	}
+	TESTS_INLINE void Test::mark_assertion(){
+		mark = Clock::ticks();
+	}
+	TESTS_INLINE void Test::print_special_result(Name name, bool pass){
+		if(fuzz_failed) fuzz_abort();
+		if(timing) time_assertion(name);
+		if(verbosity==all || (!pass && verbosity==failures))
+			current->assertion(name,pass);
+		if(!pass && fuzzing) fuzz_failed = true; // its message is written before the process aborts
+		if(timing) mark_assertion();
+		check_timeout();
+	}
+	TESTS_INLINE void Test::fuzz_abort(){
+		current->flush();
+		std::cerr << "*** assertion failed while fuzzing";
+		if(fuzzed_input()!=nullptr) std::cerr << " " << fuzzed_input();
+		std::cerr << " ***\r\n";
+		std::cerr.flush();
+		std::abort();
+	}
+	TESTS_INLINE void Test::collections_differ(Name name, Elements first, std::size_t size1, Elements second, std::size_t size2,
+		std::size_t index, std::size_t differences)
+	{
+		failed++;
+		print_result(name,false);
+		std::ostringstream text;
+		text << "collections differ at index "<<index<<", "<<differences<<" different elements (sizes "<<size1<<" and "<<size2<<").";
+		print_message(text.str());
+		std::size_t from = index>window ? index-window : 0;
+		print_window("\tfirst  ", first, size1, from, index+window+1);
+		print_window("\tsecond ", second, size2, from, index+window+1);
+	}
+	TESTS_INLINE void Test::print_window(const char* title, Elements elements, std::size_t size, std::size_t from, std::size_t to)
+	{
+		to = std::min(to, size);
+		std::ostringstream text;
+		text << title << "[" << from << ".." << to << ") :";
+		for(std::size_t i=from;i<to;i++){
+			text << ' ';
+			elements.print(text, elements.values, i);
+		}
+		print_message(text.str());
+	}
+	TESTS_INLINE void Test::check_snapshot(Name name, void* producer, void (*produce)(void*, std::ostream&)){
+		if(snapshots==nullptr){
+			fails(name, "no store of snapshots (see set_snapshots).");
+			return;
+		}
+		std::string key = stored_name()+"/"+name.str();
+		bool update = snapshots->mode()==SnapshotStore::update;
+		std::ofstream copy;
+		if(update) copy.open(snapshots->path(key, ".snapshot").c_str(), std::ios::binary | std::ios::trunc);
+		HashingBuffer buffer(update ? &copy : nullptr);
+		std::ostream output(&buffer);
+		produce(producer, output);
+		SnapshotStore::Digest digest = { buffer.digest(), buffer.size() }, expected = { 0, 0 };
+		std::string actual = snapshots->path(key, ".actual");
+		if(update){
+			snapshots->record(key, digest);
+			std::remove(actual.c_str());
+			passes(name);
+			return;
+		}
+		bool found = snapshots->find(key, expected);
+		if(found && expected.hash==digest.hash && expected.size==digest.size){
+			std::remove(actual.c_str());
+			passes(name);
+			return;
+		}
+		// the output is only hashed : it is produced again, to keep a copy for diffing
+		std::ofstream file(actual.c_str(), std::ios::binary | std::ios::trunc);
+		HashingBuffer again(&file);
+		std::ostream second(&again);
+		produce(producer, second);
+		std::ostringstream text;
+		if(found) text << "output of " << digest.size << " bytes (hash " << std::hex << digest.hash << ") but " << std::dec << expected.size
+			<< " bytes (hash " << std::hex << expected.hash << ") expected, in the snapshot " << key << ".";
+		else text << "no snapshot " << key << " : record it in update mode (see SnapshotStore).";
+		failed++;
+		print_result(name,false);
+		print_message(text.str());
+		print_message("\tthe output is written to "+actual+(again.digest()!=digest.hash ? " (it is not the same at each run)" : ""));
+	}
+	TESTS_INLINE void Test::assert_snapshot(const std::string& output, Name name){
+		assert_snapshot([&output](std::ostream& stream){ stream.write(output.data(), output.size()); }, name);
+	}
+	TESTS_INLINE void Test::record_failed(Name name, const std::string& message, const std::string& record){
+		failed++;
+		print_result(name,false);
+		print_message(message);
+		print_message("\trecord : "+record);
+	}
+	TESTS_INLINE void Test::membership_failed(Name name, Elements wrong, std::size_t count, bool present)
+	{
+		failed++;
+		print_result(name,false);
+		std::ostringstream text;
+		text << count << (count>1 ? " elements" : " element") << (present ? " not founded :" : " founded :");
+		print_message(text.str());
+		for(std::size_t i=0;i<count;i+=16){
+			std::ostringstream line;
+			line << "\t";
+			for(std::size_t j=i;j<count && j<i+16;j++){
+				if(j>i) line << ' ';
+				wrong.print(line, wrong.values, j);
+			}
+			print_message(line.str());
+		}
+	}
+	TESTS_INLINE void Test::memory_failed(Name name, std::uint64_t measured, std::uint64_t bytes, std::uint64_t limit, bool peak){
+		failed++;
+		print_result(name,false);
+		std::ostringstream text;
+		if(!allocations_counted()) text << "allocations are not counted : define TESTS_COUNT_ALLOCATIONS in one file of the program.";
+		else if(peak) text << "peak of " << measured << " bytes but less than " << limit << " expected.";
+		else text << measured << (measured>1 ? " allocations (" : " allocation (") << bytes << " bytes) but at most " << limit << " expected.";
+		print_message(text.str());
+	}
+	TESTS_INLINE void Test::fails(Name name, const char* message){
+		failed++;
+		print_result(name,false);
+		print_message(message);
+	}
+	TESTS_INLINE void Test::fails(Name name, Value expected, Value computed){
+		failed++;
+		print_result(name,false);
+		std::ostringstream text;
+		expected.print(text, expected.value);
+		text << " expected but ";
+		computed.print(text, computed.value);
+		text << " gets.";
+		print_message(text.str());
+	}
+#if defined(__GNUC__)
+#pragma GCC diagnostic pop
+#endif
+#endif
+
+	template <typename iter1, typename iter2>
+	void Test::assert_contains_all(iter1 first, iter1 last, iter2 first_value, iter2 last_value, Name name)
+	{
+		check_membership(MembershipIndex<iter1>(first,last), first_value, last_value, true, name);
+	}
+	template <typename iter1, typename iter2>
+	void Test::assert_contains_none(iter1 first, iter1 last, iter2 first_value, iter2 last_value, Name name)
+	{
+		check_membership(MembershipIndex<iter1>(first,last), first_value, last_value, false, name);
+	}
+	template <typename container1, typename container2>
+	void Test::check_membership(const container1& values, const container2& checked, bool present, Name name, std::false_type)
+	{
+		check_membership(MembershipIndex<typename container1::const_iterator>(values.begin(),values.end()),
+			checked.begin(), checked.end(), present, name);
+	}
+	// properties : the cases are numbered, and the arguments of each one are drawn from the seed and its number
+	inline std::uint64_t Test::case_seed(std::uint64_t seed, std::uint64_t index){
+		std::uint64_t x = seed ^ (index*0xD1B54A32D192ED03ULL);
+		return Random::mix(x);
+	}
+	template <typename T>
+	void Test::lower(std::atomic<T>& value, T candidate){
+		T seen = value.load();
+		while(candidate<seen && !value.compare_exchange_weak(seen, candidate)){}
+	}
+	template <typename generators, typename values, std::size_t... I>
+	void Test::generate(const generators& with, std::uint64_t seed, values& into, Indexes<I...>){
+		Random random(seed);
+		int expand[] = { 0, (std::get<I>(with).generate(random, std::get<I>(into)), 0)... };
+		(void)expand;
+	}
+	template <typename property, typename values, std::size_t... I>
+	bool Test::holds(const property& p, const values& arguments, Indexes<I...>){
+		try{
+			return p(std::get<I>(arguments)...);
+		}
+		catch(...){
+			return false;
+		}
+	}
+	template <std::size_t K, typename generators, typename values>
+	void Test::shrink_argument(const generators& with, const values& current, std::vector<values>& candidates){
+		std::vector<typename std::tuple_element<K,values>::type> simpler;
+		std::get<K>(with).shrink(std::get<K>(current), simpler);
+		for(std::size_t i=0;i<simpler.size();i++){
+			candidates.push_back(current);
+			std::get<K>(candidates.back()) = simpler[i];
+		}
+	}
+	template <typename generators, typename values, std::size_t... I>
+	void Test::shrink_arguments(const generators& with, const values& current, std::vector<values>& candidates, Indexes<I...>){
+		int expand[] = { 0, (shrink_argument<I>(with, current, candidates), 0)... };
+		(void)expand;
+	}
+	template <typename T>
+	void Test::print_argument(std::ostream& text, const T& value) { print_element(text, value); }
+	inline void Test::print_argument(std::ostream& text, const std::string& value) { text << '"' << value << '"'; }
+	template <typename T>
+	void Test::print_argument(std::ostream& text, const std::vector<T>& value){
+		text << '[';
+		for(std::size_t i=0;i<value.size();i++){
+			if(i>0) text << ' ';
+			print_argument(text, (const T&)value[i]);
+		}
+		text << ']';
+	}
+	template <typename values, std::size_t... I>
+	void Test::print_arguments(std::ostream& text, const values& arguments, Indexes<I...>){
+		int expand[] = { 0, ((I>0 ? text << ", " : text), print_argument(text, std::get<I>(arguments)), 0)... };
+		(void)expand;
+	}
+	template <typename property, typename... G>
+	void Test::check_property(const std::tuple<G...>& with, const property& p, Name name){
+		typedef std::tuple<typename G::value_type...> values;
+		typedef typename MakeIndexes<sizeof...(G)>::type indexes;
+		std::uint64_t seed = property_seed;
+		while(seed==0){
+			std::uint64_t x = Clock::ticks() ^ (std::uint64_t)std::chrono::system_clock::now().time_since_epoch().count();
+			seed = Random::mix(x);
+		}
+		const std::uint64_t cases = property_cases;
+		WorkStealingPool pool(pool_threads(property_threads));
+		// several batches by thread balance the load, big ones keep the pool out of the hot loop
+		std::uint64_t batch = std::min<std::uint64_t>(4096, std::max<std::uint64_t>(256, cases/(pool.size()*8)));
+		std::vector<values> arguments(pool.size()); // reused by each worker : generators keep their memory
+		std::atomic<std::uint64_t> failure(cases); // the first failed case
+		pool.run((std::size_t)((cases+batch-1)/batch), [&](std::size_t b, unsigned worker){
+			std::uint64_t first = b*batch, last = std::min(cases, first+batch);
+			if(first>failure.load(std::memory_order_relaxed) || timed_out) return;
+			values& current = arguments[worker];
+			for(std::uint64_t i=first;i<last;i++){
+				generate(with, case_seed(seed,i), current, indexes());
+				if(!holds(p, current, indexes())){
+					lower(failure, i);
+					return;
+				}
+			}
+		});
+		check_timeout();
+		if(failure==cases) passes(name);
+		else property_failed(with, p, name, seed, failure);
+	}
+	template <typename property, typename... G>
+	void Test::property_failed(const std::tuple<G...>& with, const property& p, Name name, std::uint64_t seed, std::uint64_t index){
+		typedef std::tuple<typename G::value_type...> values;
+		typedef typename MakeIndexes<sizeof...(G)>::type indexes;
+		values current;
+		generate(with, case_seed(seed,index), current, indexes());
+		// shrinking : the first simpler arguments which still falsify the property replace them, until none does.
+		// Candidates are checked in parallel, the first one is kept whatever the threads : the result is reproducible.
+		WorkStealingPool pool(pool_threads(property_threads));
+		std::vector<values> candidates;
+		unsigned shrinks = 0;
+		for(;shrinks<1000 && !timed_out;shrinks++){
+			candidates.clear();
+			shrink_arguments(with, current, candidates, indexes());
+			const std::size_t chunk = 16;
+			std::atomic<std::size_t> found(candidates.size());
+			pool.run((candidates.size()+chunk-1)/chunk, [&](std::size_t c, unsigned){
+				for(std::size_t i=c*chunk;i<std::min(candidates.size(),(c+1)*chunk) && i<found.load(std::memory_order_relaxed);i++)
+					if(!holds(p, candidates[i], indexes())){
+						lower(found, i);
+						return;
+					}
+			});
+			if(found==candidates.size()) break;
+			current = std::move(candidates[found]);
+		}
+		failed++;
+		print_result(name,false);
+		std::ostringstream text;
+		text << "property falsified after " << index+1 << (index>0 ? " cases" : " case") << ", shrunk " << shrinks << " times :";
+		print_message(text.str());
+		text.str("");
+		text << "\tcounterexample : (";
+		print_arguments(text, current, indexes());
+		text << ")";
+		print_message(text.str());
+		text.str("");
+		text << "\treplay with set_property_seed(" << seed << ")";
+		print_message(text.str());
+	}
+
+	template <typename hook, typename... fields>
+	void Test::check_csv(const std::string& path, const hook& h, Name name, bool header){
+		typedef std::tuple<fields...> values;
+		typedef typename MakeIndexes<sizeof...(fields)>::type indexes;
+		MappedFile file(path);
+		if(!file.valid()){
+			fails(name, ("the file "+path+" can't be read.").c_str());
+			return;
+		}
+		const char* data = file.data();
+		const std::size_t size = file.size();
+		std::size_t start = 0;
+		if(header){
+			const char* line = static_cast<const char*>(std::memchr(data, '\n', size));
+			start = line==nullptr ? size : line-data+1;
+		}
+		// each chunk checks the records which start in it : the first one follows a new line
+		const std::size_t chunk = 1<<22;
+		WorkStealingPool pool(pool_threads(data_threads));
+		std::atomic<std::size_t> failure(size); // offset of the first wrong record
+		pool.run((size-start+chunk-1)/chunk, [&](std::size_t c, unsigned){
+			std::size_t first = start+c*chunk, last = std::min(size, first+chunk);
+			if(c>0){
+				const char* line = static_cast<const char*>(std::memchr(data+first-1, '\n', size-first+1));
+				first = line==nullptr ? size : line-data+1;
+			}
+			values current;
+			std::size_t position = first, parsed;
+			while(position<last && position<failure.load(std::memory_order_relaxed) && !timed_out){
+				const char* line = static_cast<const char*>(std::memchr(data+position, '\n', size-position));
+				const char* end = line==nullptr ? data+size : line;
+				std::size_t next = line==nullptr ? size : line-data+1;
+				if(end>data+position && end[-1]=='\r') end--;
+				if(end>data+position && data[position]!='#'
+					&& (!parse_record(data+position, end, ',', current, parsed, indexes()) || !holds(h, current, indexes()))){
+					lower(failure, position);
+					break;
+				}
+				position = next;
+			}
+			file.release(first, position-first);
+		});
+		check_timeout();
+		if(failure==size){
+			passes(name);
+			return;
+		}
+		// the first wrong record is parsed again, to tell why it is wrong
+		const char* record = data+failure;
+		const char* end = static_cast<const char*>(std::memchr(record, '\n', size-failure));
+		if(end==nullptr) end = data+size;
+		if(end>record && end[-1]=='\r') end--;
+		values current;
+		std::size_t parsed;
+		std::ostringstream text;
+		text << "record at line " << std::count(data, record, '\n')+1 << " of " << path;
+		if(!parse_record(record, end, ',', current, parsed, indexes())){
+			if(parsed<sizeof...(fields)) text << " : the field " << parsed+1 << " can't be parsed.";
+			else text << " : more than " << sizeof...(fields) << " fields.";
+		}
+		else text << " is wrong.";
+		record_failed(name, text.str(), std::string(record, end));
+	}
+	template <typename hook, typename... fields>
+	void Test::check_binary(const std::string& path, const hook& h, Name name){
+		typedef std::tuple<fields...> values;
+		typedef typename MakeIndexes<sizeof...(fields)>::type indexes;
+		static_assert(sizeof...(fields)>0, "for_each_binary needs at least one field");
+		const std::size_t record_size = sum_of_sizes<fields...>();
+		MappedFile file(path);
+		if(!file.valid()){
+			fails(name, ("the file "+path+" can't be read.").c_str());
+			return;
+		}
+		const char* data = file.data();
+		const std::size_t records = file.size()/record_size;
+		if(file.size()%record_size!=0){
+			std::ostringstream text;
+			text << "the size of " << path << " is not a multiple of the size of a record (" << record_size << " bytes).";
+			fails(name, text.str().c_str());
+			return;
+		}
+		const std::size_t chunk = std::max<std::size_t>(1, (1<<22)/record_size);
+		WorkStealingPool pool(pool_threads(data_threads));
+		std::atomic<std::size_t> failure(records);
+		pool.run((records+chunk-1)/chunk, [&](std::size_t c, unsigned){
+			std::size_t first = c*chunk, last = std::min(records, first+chunk), index = first;
+			values current;
+			for(;index<last && index<failure.load(std::memory_order_relaxed) && !timed_out;index++){
+				read_record(data+index*record_size, current, indexes());
+				if(!holds(h, current, indexes())){
+					lower(failure, index);
+					break;
+				}
+			}
+			file.release(first*record_size, (index-first)*record_size);
+		});
+		check_timeout();
+		if(failure==records){
+			passes(name);
+			return;
+		}
+		values current;
+		read_record(data+failure*record_size, current, indexes());
+		std::ostringstream text, record;
+		text << "record " << failure << " (at byte " << failure*record_size << ") of " << path << " is wrong.";
+		print_arguments(record, current, indexes());
+		record_failed(name, text.str(), record.str());
+	}
+
+#if defined(TESTS_SEPARATE_COMPILATION) && defined(TESTS_IMPLEMENTATION)
+	// the assertions on common types, declared extern by test_decl.h
+	TESTS_COMMON_VALUES(TESTS_VALUE_INSTANTIATION, )
+	TESTS_COMMON_COLLECTIONS(TESTS_COLLECTION_INSTANTIATION, )
+#endif
+
+	/**
+	 * Durations of the tests measured by the previous runs, used by suites to balance their shards and
+	 * to start the longest tests first (see Suite::set_timing_database).
+	 * It is a text file, loaded by the constructor and saved by save() or the destructor.
+	*/
+	class TimingDatabase
+	{
+		private:
+			std::string path;
+			mutable std::mutex lock;
+			std::unordered_map<std::string, double> durations; // milliseconds
+			bool changed;
+		public:
+		/**
+		 * Loads a database
+		 * @param path the file of the database (created by save() if it does not exist)
+		*/
+			explicit TimingDatabase(const std::string& path) : path(path), changed(false){
+				std::ifstream file(path.c_str());
+				std::string line;
+				while(std::getline(file, line)){
+					std::istringstream fields(line);
+					double duration;
+					std::string name;
+					fields >> duration;
+					fields.get();
+					if(fields && std::getline(fields, name) && !name.empty()) durations[name] = duration;
+				}
+			}
+			~TimingDatabase(){
+				save();
+			}
+		/**
+		 * Finds the duration of a test
+		 * @param name the name of the test
+		 * @param duration the duration found, in milliseconds
+		 * @returns true if the test has a duration
+		*/
+			bool find(const std::string& name, double& duration) const {
+				std::lock_guard<std::mutex> guard(lock);
+				std::unordered_map<std::string, double>::const_iterator found = durations.find(name);
+				if(found==durations.end()) return false;
+				duration = found->second;
+				return true;
+			}
+		/**
+		 * Records the duration of a run of a test : the duration of the test becomes a moving average of its runs
+		 * @param name the name of the test
+		 * @param duration the duration of the run, in milliseconds
+		*/
+			void record(const std::string& name, double duration){
+				std::lock_guard<std::mutex> guard(lock);
+				std::unordered_map<std::string, double>::iterator found = durations.find(name);
+				if(found==durations.end()) durations[name] = duration;
+				else found->second = 0.7*found->second+0.3*duration;
+				changed = true;
+			}
+		/**
+		 * Writes the database to its file, if it has changed
+		*/
+			void save(){
+				std::lock_guard<std::mutex> guard(lock);
+				if(!changed) return;
+				std::string temporary = path+".tmp";
+				{
+					std::ofstream file(temporary.c_str(), std::ios::trunc);
+					file.precision(17);
+					for(const auto& duration : durations)
+						file << duration.second << ' ' << duration.first << '\n';
+					if(!file) return;
+				}
+				if(std::rename(temporary.c_str(), path.c_str())==0) changed = false;
+			}
+	};
+
+	/**
+	 * A suite runs many tests concurrently on a work-stealing pool.
+	 * Each test writes into its own buffer, and all buffers are flushed in the order
+	 * of insertion when every test is finished, followed by an aggregated summary.
+	 * Tests of a suite must be independent : they may run on any thread, in any order.
+	 *
+	 * In isolated mode (POSIX systems only), each test runs in a child process taken from a pool of
+	 * pre-forked workers, so a test which crashes or loops forever is killed (and its worker respawned)
+	 * without losing the results of the other tests. Results come back through a shared memory ring as the
+	 * assertions are reported, so the results of a test reported before it is killed are kept.
+	 *
+	 * A suite may be split into shards run by several processes or machines : the tests are dealt to the shards
+	 * by duration (see set_shard and set_timing_database), and each shard runs the longest tests first.
+	*/
+	class Suite
+	{
+		private:
+			struct Entry
+			{
+				Test* test;
+				std::unique_ptr<Test> owned;
+				std::string report;
+				int passed;
+				int failed;
+				double time;
+				double cpu;
+				bool scheduled; // the test belongs to the shard
+				bool cached; // its result is read from the cache
+			};
+			std::vector<std::unique_ptr<Entry>> entries;
+			std::unordered_map<std::string, unsigned> ranks; // number of tests of each name
+			std::ostream& output;
+			unsigned threads;
+			bool isolated;
+			ResultCache* cache;
+			TimingDatabase* durations;
+			unsigned shard_index;
+			unsigned shard_count;
+			bool shared; // several tests run at once
+			std::string environment; // the error of the shard given by the environment
+			Chrono chrono;
+
+			// reads a number of the environment : digits only
+			static bool parse_number(const char* text, unsigned& value)
+			{
+				if(text==nullptr) return false;
+				std::size_t length = std::strlen(text);
+				if(length==0 || length>9 || std::strspn(text, "0123456789")!=length) return false;
+				value = (unsigned)std::strtoul(text, nullptr, 10);
+				return true;
+			}
+
+			// the tests of the shard, the ones which failed during their last run first, then the longest ones.
+			// Tests are dealt to the shards by greedy bin-packing : the longest one goes to the least loaded shard.
+			std::vector<std::size_t> schedule()
+			{
+				std::size_t count = entries.size();
+				std::vector<std::string> names(count);
+				std::vector<double> cost(count, -1);
+				double known=0;
+				std::size_t known_count=0;
+				for(std::size_t i=0;i<count;i++){
+					names[i] = entries[i]->test->stored_name();
+					if(durations!=nullptr && durations->find(names[i], cost[i])){
+						known += cost[i];
+						known_count++;
+					}
+				}
+				// tests never run are expected to last as long as the average one
+				double unknown = known_count>0 ? known/known_count : 1;
+				for(std::size_t i=0;i<count;i++)
+					if(cost[i]<0) cost[i] = unknown;
+				std::vector<std::size_t> order;
+				for(std::size_t i=0;i<count;i++) order.push_back(i);
+				// ties are broken by name : every shard computes the same dealing
+				std::sort(order.begin(), order.end(), [&](std::size_t a, std::size_t b){
+					return cost[a]!=cost[b] ? cost[a]>cost[b] : names[a]!=names[b] ? names[a]<names[b] : a<b;
+				});
+				std::vector<double> load(shard_count, 0);
+				std::vector<std::size_t> selected;
+				for(std::size_t i : order){
+					unsigned shard = (unsigned)(std::min_element(load.begin(), load.end())-load.begin());
+					load[shard] += cost[i];
+					entries[i]->scheduled = shard==shard_index;
+					if(entries[i]->scheduled) selected.push_back(i);
+				}
+				std::stable_partition(selected.begin(), selected.end(), [this](std::size_t i){
+					return entries[i]->test->failed_before();
+				});
+				return selected;
+			}
+
+			void run_entry(Entry& entry, bool guarded)
+			{
+				std::ostringstream buffer;
+				StreamReporter reporter(buffer);
+				bool buffered = entry.test->reporter==nullptr;
+				if(buffered) entry.test->reporter = &reporter;
+				entry.test->cores_shared = shared;
+				double cpu = thread_cpu_time();
+				entry.test->execute(guarded);
+				entry.cpu = (thread_cpu_time()-cpu)/1000000.0;
+				entry.test->cores_shared = false;
+				if(buffered) entry.test->reporter = nullptr;
+				entry.report = buffer.str();
+				entry.passed = entry.test->passed_count();
+				entry.failed = entry.test->failed_count();
+				entry.time = entry.test->time();
+			}
+
+#if defined(__unix__) || defined(__APPLE__)
+			static const std::size_t ring_size = 1<<20;
+			// shared memory between the suite and one worker process
+			struct Channel
+			{
+				std::atomic<long long> task; // written by the suite : index of the test to run, -1 when none, -2 to quit
+				std::atomic<unsigned long long> head; // bytes written in the ring by the worker
+				std::atomic<unsigned long long> tail; // bytes read from the ring by the suite
+				std::atomic<long long> cpu_start; // CPU time used by the worker when its task started, in microseconds
+				char ring[ring_size];
+			};
+			// header of a result record in a ring, followed by the text of the report : a task publishes a record
+			// for each event reported, then a last one with its time
+			struct Record
+			{
+				unsigned long long size;
+				long long task;
+				int passed;
+				int failed;
+				double time;
+				double cpu;
+				bool last;
+			};
+			struct Worker
+			{
+				pid_t pid;
+				long long task;
+				std::chrono::steady_clock::time_point started;
+			};
+
+			static void backoff(unsigned& spins)
+			{
+				if(++spins<1000) std::this_thread::yield();
+				else std::this_thread::sleep_for(std::chrono::microseconds(spins<2000 ? 20 : 200));
+			}
+			static void ring_write(Channel& channel, unsigned long long head, const char* data, std::size_t size)
+			{
+				unsigned spins=0;
+				while(ring_size-(head-channel.tail.load(std::memory_order_acquire)) < size)
+					backoff(spins);
+				for(std::size_t i=0;i<size;i++)
+					channel.ring[(head+i)%ring_size] = data[i];
+			}
+			static void ring_read(const Channel& channel, unsigned long long from, char* data, std::size_t size)
+			{
+				for(std::size_t i=0;i<size;i++)
+					data[i] = channel.ring[(from+i)%ring_size];
+			}
+			static double elapsed(const Worker& worker)
+			{
+				return std::chrono::duration<double,std::milli>(std::chrono::steady_clock::now()-worker.started).count();
+			}
+			static long long microseconds(const rusage& usage)
+			{
+				return (long long)(usage.ru_utime.tv_sec+usage.ru_stime.tv_sec)*1000000+usage.ru_utime.tv_usec+usage.ru_stime.tv_usec;
+			}
+			static void publish(Channel& channel, Record record, const char* text, std::size_t size)
+			{
+				const std::size_t limit = ring_size/2;
+				static const char truncated[] = "\r\n*** report truncated ***\r\n";
+				bool cut = size>limit;
+				if(cut) size = limit;
+				record.size = size+(cut ? sizeof(truncated)-1 : 0);
+				unsigned long long head = channel.head.load(std::memory_order_relaxed);
+				ring_write(channel, head, reinterpret_cast<const char*>(&record), sizeof(record));
+				ring_write(channel, head+sizeof(record), text, size);
+				if(cut) ring_write(channel, head+sizeof(record)+size, truncated, sizeof(truncated)-1);
+				channel.head.store(head+sizeof(record)+record.size, std::memory_order_release);
+			}
+			// reporter of a worker process : publishes each event with the counters of the test
+			class Publisher : public Reporter
+			{
+				private:
+					Channel& channel;
+					long long task;
+					const Test& test;
+					std::ostringstream text;
+					StreamReporter format;
+					void send(){
+						Record record = Record();
+						record.task = task;
+						record.passed = test.passed_count();
+						record.failed = test.failed_count();
+						std::string data = text.str();
+						publish(channel, record, data.data(), data.size());
+						text.str(std::string());
+					}
+				public:
+					Publisher(Channel& channel, long long task, const Test& test)
+						: channel(channel), task(task), test(test), format(text){}
+					void started(Name name) override { format.started(name); send(); }
+					// a failed assertion is published with its message
+					void assertion(Name name, bool pass) override { format.assertion(name, pass); if(pass) send(); }
+					void message(Name line) override { format.message(line); send(); }
+					void ended(int passed, int failed, double time) override { format.ended(passed, failed, time); send(); }
+			};
+
+			// body of a worker process : never returns
+			void work(Channel& channel)
+			{
+				for(;;){
+					unsigned spins=0;
+					long long task;
+					while((task=channel.task.load(std::memory_order_acquire))==-1)
+						backoff(spins);
+					if(task<0) _exit(0);
+					channel.task.store(-1, std::memory_order_relaxed);
+
+					Entry& entry = *entries[(std::size_t)task];
+					rusage usage;
+					getrusage(RUSAGE_SELF, &usage);
+					channel.cpu_start.store(microseconds(usage), std::memory_order_relaxed);
+					// the reporter of the test is replaced : its results must reach the suite before the worker may be lost
+					Publisher publisher(channel, task, *entry.test);
+					Reporter* reporter = entry.test->reporter;
+					entry.test->reporter = &publisher;
+					run_entry(entry, false);
+					entry.test->reporter = reporter;
+					std::cout.flush();
+					Record record = Record();
+					record.task = task;
+					record.passed = entry.passed;
+					record.failed = entry.failed;
+					record.time = entry.time;
+					record.cpu = entry.cpu;
+					record.last = true;
+					publish(channel, record, entry.report.data(), entry.report.size());
+				}
+			}
+			pid_t spawn(Channel& channel)
+			{
+				std::cout.flush();
+				output.flush();
+				channel.task.store(-1);
+				channel.head.store(0);
+				channel.tail.store(0);
+				channel.cpu_start.store(0);
+				pid_t pid = fork();
+				if(pid<0) throw std::runtime_error("tests::Suite : cannot fork a worker");
+				if(pid==0) work(channel);
+				return pid;
+			}
+			// reads the records published by a worker, returns true if the last record of its current task was read
+			bool drain(Channel& channel, const Worker& worker)
+			{
+				bool finished=false;
+				unsigned long long head = channel.head.load(std::memory_order_acquire);
+				unsigned long long tail = channel.tail.load(std::memory_order_relaxed);
+				while(head-tail >= sizeof(Record)){
+					Record record;
+					ring_read(channel, tail, reinterpret_cast<char*>(&record), sizeof(record));
+					Entry& entry = *entries[(std::size_t)record.task];
+					std::size_t size = entry.report.size();
+					entry.report.resize(size+record.size);
+					if(record.size>0) ring_read(channel, tail+sizeof(Record), &entry.report[size], record.size);
+					entry.passed = record.passed;
+					entry.failed = record.failed;
+					entry.time = record.time;
+					entry.cpu = record.cpu;
+					tail += sizeof(Record)+record.size;
+					channel.tail.store(tail, std::memory_order_release);
+					if(record.last && record.task==worker.task) finished=true;
+				}
+				return finished;
+			}
+			// records the failure of a test whose worker has been lost, after the results it published
+			void lose(Entry& entry, const std::string& reason, double time, double cpu)
+			{
+				std::ostringstream report;
+				if(entry.report.empty()) report << "Start of unit tests.\r\n";
+				entry.failed++;
+				report << "\ttest *** "<<reason<<" *** failed \r\n";
+				report << "Tests ended. "<<entry.passed<<" tests passed and "<<entry.failed<<" failed.\r\n";
+				report << "Total test time is "<<time<<" ms.\r\n";
+				entry.report += report.str();
+				entry.time = time;
+				entry.cpu = cpu;
+			}
+			// CPU time of the current task of a worker which has been waited for, in milliseconds
+			static double task_cpu(const Channel& channel, const rusage& usage)
+			{
+				return std::max(0LL, microseconds(usage)-channel.cpu_start.load(std::memory_order_relaxed))/1000.0;
+			}
+
+			void run_isolated(unsigned workers, const std::vector<std::size_t>& order)
+			{
+				std::size_t count = order.size();
+				workers = (unsigned)std::min<std::size_t>(workers, count);
+				if(workers==0) return;
+				void* memory = mmap(nullptr, sizeof(Channel)*workers, PROT_READ|PROT_WRITE, MAP_SHARED|MAP_ANONYMOUS, -1, 0);
+				if(memory==MAP_FAILED) throw std::runtime_error("tests::Suite : cannot map shared memory");
+				Channel* channels = static_cast<Channel*>(memory);
+				std::vector<Worker> pool(workers);
+				for(unsigned w=0;w<workers;w++){
+					new (&channels[w]) Channel();
+					pool[w].task = -1;
+					pool[w].pid = spawn(channels[w]);
+				}
+
+				std::size_t next=0, done=0;
+				unsigned spins=0;
+				while(done<count){
+					bool progress=false;
+					for(unsigned w=0;w<workers;w++){
+						Worker& worker = pool[w];
+						if(worker.task>=0 && drain(channels[w],worker)){
+							worker.task=-1;
+							done++;
+							progress=true;
+						}
+						if(worker.task<0 && next<count){
+							worker.task = (long long)order[next++];
+							Entry& entry = *entries[(std::size_t)worker.task];
+							entry.report.clear();
+							entry.passed = entry.failed = 0;
+							worker.started = std::chrono::steady_clock::now();
+							channels[w].task.store(worker.task, std::memory_order_release);
+							progress=true;
+						}
+					}
+					// workers killed by a signal (crash) or which exited : only the workers of the suite are waited for
+					for(unsigned w=0;w<workers;w++){
+						Worker& worker = pool[w];
+						int status;
+						rusage usage;
+						if(wait4(worker.pid, &status, WNOHANG, &usage)<=0) continue;
+						if(worker.task>=0){
+							if(!drain(channels[w],worker)){
+								std::ostringstream reason;
+								if(WIFSIGNALED(status))
+									reason << "killed by signal "<<WTERMSIG(status)<<" ("<<strsignal(WTERMSIG(status))<<")";
+								else
+									reason << "worker exited with status "<<WEXITSTATUS(status);
+								lose(*entries[(std::size_t)worker.task], reason.str(), elapsed(worker), task_cpu(channels[w], usage));
+							}
+							done++;
+							worker.task=-1;
+						}
+						worker.pid = spawn(channels[w]);
+						progress=true;
+					}
+					// workers whose test is over its timeout
+					for(unsigned w=0;w<workers;w++){
+						Worker& worker = pool[w];
+						if(worker.task<0) continue;
+						unsigned long timeout = entries[(std::size_t)worker.task]->test->timeout();
+						double time = elapsed(worker);
+						if(timeout==infinite || time<timeout) continue;
+						kill(worker.pid, SIGKILL);
+						int status;
+						rusage usage;
+						wait4(worker.pid, &status, 0, &usage);
+						if(!drain(channels[w],worker))
+							lose(*entries[(std::size_t)worker.task], "timeout", time, task_cpu(channels[w], usage));
+						done++;
+						worker.task=-1;
+						worker.pid = spawn(channels[w]);
+						progress=true;
+					}
+					if(progress) spins=0;
+					else backoff(spins);
+				}
+				for(unsigned w=0;w<workers;w++){
+					channels[w].task.store(-2, std::memory_order_release);
+					waitpid(pool[w].pid, nullptr, 0);
+					channels[w].~Channel();
+				}
+				munmap(memory, sizeof(Channel)*workers);
+			}
+#endif
+		public:
+		/**
+		 * Initialize the suite. An invalid shard in the environment (see set_shard) is reported by run(),
+		 * which then runs the whole suite and counts it as a failed test.
+		 * @param output the stream to output the results (default : the standard output)
+		 * @param threads number of threads, or of worker processes in isolated mode (default : the number of cores of the machine)
+		*/
+			Suite(std::ostream& output=std::cout, unsigned threads=0)
+				: output(output), threads(threads), isolated(false), cache(nullptr), durations(nullptr), shard_index(0), shard_count(1), shared(false){
+				const char* index = std::getenv("TESTS_SHARD_INDEX");
+				const char* count = std::getenv("TESTS_TOTAL_SHARDS");
+				if(index==nullptr && count==nullptr) return;
+				unsigned i, n;
+				if(parse_number(index, i) && parse_number(count, n) && i<n){
+					shard_index = i;
+					shard_count = n;
+				}
+				else environment = std::string("invalid shard in the environment : TESTS_SHARD_INDEX=")+(index!=nullptr ? index : "")
+					+" and TESTS_TOTAL_SHARDS="+(count!=nullptr ? count : "");
+			}
+		/**
+		 * Adds a test to the suite. The test must live until the end of run().
+		 * Tests which have the same name are told apart in the cache and the timing database by their rank.
+		 * @param test the test to add
+		*/
+			void add(Test& test)
+			{
+				std::unique_ptr<Entry> entry(new Entry());
+				entry->test = &test;
+				test.rank = ranks[test.name()]++;
+				entry->passed = entry->failed = 0;
+				entry->time = entry->cpu = 0;
+				entry->scheduled = true;
+				entry->cached = false;
+				entries.push_back(std::move(entry));
+			}
+		/**
+		 * Adds a test to the suite, which becomes the owner of the test
+		 * @param test the test to add
+		*/
+			void add(std::unique_ptr<Test> test)
+			{
+				add(*test);
+				entries.back()->owned = std::move(test);
+			}
+		/**
+		 * @returns the number of tests of the suite
+		*/
+			std::size_t size() const { return entries.size(); }
+		/**
+		 * Enables or disables the isolated mode : each test runs in a pre-forked worker process,
+		 * which is killed when the timeout of the test is over and respawned after a crash.
+		 * Available on POSIX systems only. Tests run in isolated mode do not update the test objects of the suite,
+		 * and their results go to the output of the suite, whatever the reporters of the tests.
+		 * @param enabled true to run tests in worker processes
+		 * @throws std::logic_error if the isolated mode is not available
+		*/
+			void set_isolated(bool enabled)
+			{
+#if defined(__unix__) || defined(__APPLE__)
+				isolated = enabled;
+#else
+				if(enabled) throw std::logic_error("tests::Suite : isolated mode needs a POSIX system");
+#endif
+			}
+		/**
+		 * Sets the cache of the results of the tests which have none (see Test::set_cache) :
+		 * unchanged tests which passed are not run again, and tests which failed run first.
+		 * @param cache the cache (must live while the suite runs), or nullptr
+		*/
+			void set_cache(ResultCache* cache) { this->cache = cache; }
+		/**
+		 * Sets the database of the durations of the tests, which is updated by each run : the shards are balanced
+		 * with these durations, and the longest tests start first. All the shards must use the same database.
+		 * @param database the database (must live while the suite runs), or nullptr
+		*/
+			void set_timing_database(TimingDatabase* database) { durations = database; }
+		/**
+		 * Runs only one shard of the suite (default : the shard given by the environment variables
+		 * TESTS_SHARD_INDEX and TESTS_TOTAL_SHARDS, or the whole suite)
+		 * @param index the index of the shard, in [0, count)
+		 * @param count the number of shards
+		 * @throws std::invalid_argument if the index is not lower than the count
+		*/
+			void set_shard(unsigned index, unsigned count)
+			{
+				if(index>=count) throw std::invalid_argument("tests::Suite : invalid shard");
+				shard_index = index;
+				shard_count = count;
+				environment.clear();
+			}
+		/**
+		 * Reads the options of the suite in the arguments of the program : --shard=index/count
+		 * @param argc the number of arguments
+		 * @param argv the arguments
+		 * @throws std::invalid_argument if the shard is invalid
+		*/
+			void parse_arguments(int argc, char** argv)
+			{
+				for(int i=1;i<argc;i++){
+					unsigned index, count;
+					if(std::sscanf(argv[i], "--shard=%u/%u", &index, &count)==2) set_shard(index, count);
+				}
+			}
+		/**
+		 * Runs all the tests and outputs their results, then the summary
+		 * @returns the number of tests which have at least one failed assertion, plus one if the shard
+		 * of the environment is invalid
+		*/
+			int run()
+			{
+				WorkStealingPool pool(threads);
+				ResultCache::Result result;
+				for(auto& entry : entries){
+					if(entry->test->cache==nullptr) entry->test->cache = cache;
+					entry->cached = entry->test->cached_result(result);
+				}
+				if(!environment.empty()) output << "*** " << environment << ", the whole suite runs ***\r\n";
+				std::vector<std::size_t> order = schedule();
+				shared = pool.size()>1 && order.size()>1;
+				chrono.start();
+				// the shared fixtures of the tests are built in parallel before them : a fixture whose build fails
+				// is built again by the tests which need it, which fail. In isolated mode, the workers are forked
+				// before any thread of the suite starts, and each one builds the fixtures of its tests
+				std::vector<Fixture*> fixtures;
+				std::unordered_set<Fixture*> declared;
+				for(std::size_t i : order)
+					if(!isolated && !entries[i]->cached)
+						for(Fixture* fixture : entries[i]->test->fixtures)
+							if(declared.insert(fixture).second) fixtures.push_back(fixture);
+				Chrono building;
+				building.start();
+				pool.run(fixtures.size(), [&fixtures](std::size_t i, unsigned){
+					try{
+						fixtures[i]->prepare();
+					}
+					catch(...){}
+				});
+				building.stop();
+#if defined(__unix__) || defined(__APPLE__)
+				if(isolated)
+					run_isolated(pool.size(), order);
+				else
+#endif
+				pool.run(order.size(), [this,&order](std::size_t i, unsigned){
+					run_entry(*entries[order[i]], true);
+				});
+				chrono.stop();
+				for(std::size_t i : order){
+					Entry& entry = *entries[i];
+					entry.test->to_cache(entry.passed, entry.failed, entry.time);
+					if(durations!=nullptr && !entry.cached) durations->record(entry.test->stored_name(), entry.time);
+				}
+				if(cache!=nullptr) cache->save();
+				if(durations!=nullptr) durations->save();
+
+				int passed=0, failed=0, tests_failed=0;
+				double cpu=0;
+				for(auto& entry : entries){
+					if(!entry->scheduled) continue;
+					output << "=== " << entry->test->name() << "\r\n";
+					output << entry->report;
+					entry->report.clear();
+					passed += entry->passed;
+					failed += entry->failed;
+					if(entry->failed>0) tests_failed++;
+					cpu += entry->cpu;
+				}
+				if(shard_count>1)
+					output << "Shard "<<shard_index<<" of "<<shard_count<<" : "<<order.size()<<" tests of "<<entries.size()<<".\r\n";
+				output << "Suite ended. "<<order.size()<<" tests run on "<<pool.size()
+					<<(isolated?" worker processes, ":" threads, ")<<tests_failed<<" failed.\r\n";
+				output << "Assertions : "<<passed<<" passed and "<<failed<<" failed.\r\n";
+				if(!fixtures.empty())
+					output << "Shared fixtures : "<<fixtures.size()<<" built in "<<building.time()<<" ms.\r\n";
+				output << "Wall time is "<<chrono.time()<<" ms, summed CPU time is "<<cpu<<" ms.\r\n";
+				if(!environment.empty()){
+					output << "*** " << environment << " ***\r\n";
+					tests_failed++;
+				}
+				return tests_failed;
+			}
+	};
+
+	/**
+	 * Robust statistics of a set of samples
+	*/
+	struct Statistics
+	{
+		std::size_t count;
+		double min;
+		double median;
+		double mean;
+		double p99;
+		double mad; // median absolute deviation
+
+		Statistics() : count(0), min(0), median(0), mean(0), p99(0), mad(0){}
+	/**
+	 * computes the statistics
+	 * @param samples the samples (they are sorted)
+	 * @returns the statistics of the samples
+	*/
+		static Statistics of(std::vector<double>& samples){
+			Statistics result;
+			result.count = samples.size();
+			if(samples.empty()) return result;
+			std::sort(samples.begin(), samples.end());
+			result.min = samples.front();
+			result.median = percentile(samples, 0.5);
+			result.p99 = percentile(samples, 0.99);
+			double sum=0;
+			for(double sample : samples) sum += sample;
+			result.mean = sum/samples.size();
+			std::vector<double> deviations;
+			deviations.reserve(samples.size());
+			for(double sample : samples) deviations.push_back(std::abs(sample-result.median));
+			std::sort(deviations.begin(), deviations.end());
+			result.mad = percentile(deviations, 0.5);
+			return result;
+		}
+	/**
+	 * @param sorted samples, in ascending order (not empty)
+	 * @param rank the rank, in [0,1]
+	 * @returns the percentile of the samples, linearly interpolated
+	*/
+		static double percentile(const std::vector<double>& sorted, double rank){
+			double position = rank*(sorted.size()-1);
+			std::size_t below = (std::size_t)position;
+			if(below+1>=sorted.size()) return sorted.back();
+			double fraction = position-below;
+			return sorted[below]*(1-fraction)+sorted[below+1]*fraction;
+		}
+	};
+
+	/**
+	 * Store of the samples of benchmarks (and of the time assertions of tests), to detect regressions between runs.
+	 * Each benchmark has its own versioned file in a directory, with the raw samples of its reference run.
+	 * In record mode, the samples of a run replace the baseline ; in compare mode, they are compared to the baseline
+	 * by a Mann-Whitney U test : a benchmark is slower (or faster) when the difference is significant and the
+	 * medians differ by more than a threshold. The mode may be read in the environment (TESTS_BASELINE=record)
+	 * or in the arguments of the program (--baseline=record or --baseline=compare).
+	*/
+	class BaselineStore
+	{
+		public:
+			enum Mode
+			{
+				record,
+				compare
+			};
+		/**
+		 * Comparison of a run with its baseline
+		*/
+			struct Comparison
+			{
+				enum Verdict
+				{
+					missing, // no baseline (or record mode)
+					unchanged,
+					faster,
+					slower
+				};
+				Verdict verdict;
+				double p_value; // two-sided, of the Mann-Whitney U test
+				double change; // relative change of the median : +0.1 is 10% slower
+				double baseline_median;
+				double current_median;
+
+				Comparison() : verdict(missing), p_value(1), change(0), baseline_median(0), current_median(0){}
+			};
+		private:
+			static const int version = 1;
+			std::string directory;
+			Mode current;
+			double alpha;
+			double threshold;
+			mutable std::mutex lock;
+			int slower_count;
+
+			std::string file(const std::string& name) const {
+				return directory+"/"+file_name(name)+".baseline";
+			}
+		public:
+		/**
+		 * Opens a store
+		 * @param directory the directory of the files (created if needed)
+		 * @param mode record or compare the samples (default : compare, record if TESTS_BASELINE is "record")
+		 * @param alpha the significance level of the test (default : 0.01)
+		 * @param threshold the minimum relative change of the median (default : 0.05, 5%)
+		*/
+			explicit BaselineStore(const std::string& directory, Mode mode=compare, double alpha=0.01, double threshold=0.05)
+				: directory(directory), current(mode), alpha(alpha), threshold(threshold), slower_count(0){
+				const char* variable = std::getenv("TESTS_BASELINE");
+				if(variable!=nullptr && std::strcmp(variable, "record")==0) current = record;
+#if defined(__unix__) || defined(__APPLE__)
+				mkdir(directory.c_str(), 0777);
+#endif
+			}
+		/**
+		 * Reads the mode in the arguments of the program : --baseline=record or --baseline=compare
+		 * @param argc the number of arguments
+		 * @param argv the arguments
+		*/
+			void parse_arguments(int argc, char** argv){
+				for(int i=1;i<argc;i++){
+					if(std::strcmp(argv[i], "--baseline=record")==0) current = record;
+					else if(std::strcmp(argv[i], "--baseline=compare")==0) current = compare;
+				}
+			}
+		/**
+		 * @returns the mode of the store
+		*/
+			Mode mode() const { return current; }
+		/**
+		 * Reads the baseline of a benchmark
+		 * @param name the name of the benchmark
+		 * @param samples the samples of the baseline
+		 * @returns true if the benchmark has a baseline, of the current version
+		*/
+			bool load(const std::string& name, std::vector<double>& samples) const {
+				std::ifstream input(file(name).c_str());
+				std::string magic, key, stored;
+				int format = 0;
+				std::size_t count = 0;
+				input >> magic >> format >> key;
+				input.get();
+				std::getline(input, stored);
+				if(!input || magic!="tests-baseline" || format!=version || key!="name" || stored!=name) return false;
+				input >> key >> count;
+				if(!input || key!="samples") return false;
+				samples.clear();
+				double sample;
+				while(samples.size()<count && input >> sample) samples.push_back(sample);
+				return samples.size()==count && count>0;
+			}
+		/**
+		 * Writes the baseline of a benchmark
+		 * @param name the name of the benchmark
+		 * @param samples the samples, in nanoseconds per operation
+		 * @returns true if the file is written
+		*/
+			bool save(const std::string& name, const std::vector<double>& samples) const {
+				std::string path = file(name), temporary = path+".tmp";
+				{
+					std::ofstream output(temporary.c_str(), std::ios::trunc);
+					output.precision(17);
+					output << "tests-baseline " << version << "\nname " << name << "\nsamples " << samples.size() << '\n';
+					for(double sample : samples) output << sample << '\n';
+					if(!output) return false;
+				}
+				return std::rename(temporary.c_str(), path.c_str())==0;
+			}
+		/**
+		 * Records the samples of a run (record mode) or compares them to the baseline (compare mode)
+		 * @param name the name of the benchmark
+		 * @param samples the samples of the run
+		 * @returns the comparison (missing in record mode)
+		*/
+			Comparison check(const std::string& name, const std::vector<double>& samples){
+				Comparison result;
+				if(current==record){
+					save(name, samples);
+					return result;
+				}
+				std::vector<double> baseline;
+				if(!load(name, baseline)) return result;
+				result = compare_samples(baseline, samples, alpha, threshold);
+				if(result.verdict==Comparison::slower){
+					std::lock_guard<std::mutex> guard(lock);
+					slower_count++;
+				}
+				return result;
+			}
+		/**
+		 * @returns the number of benchmarks found slower than their baseline
+		*/
+			int regressions() const {
+				std::lock_guard<std::mutex> guard(lock);
+				return slower_count;
+			}
+		/**
+		 * @returns the exit status of the program : 1 if a benchmark is slower than its baseline, else 0
+		*/
+			int exit_status() const { return regressions()>0 ? 1 : 0; }
+		/**
+		 * Compares two sets of samples
+		 * @param baseline the samples of the reference
+		 * @param samples the samples to compare
+		 * @param alpha the significance level
+		 * @param threshold the minimum relative change of the median
+		 * @returns the comparison
+		*/
+			static Comparison compare_samples(const std::vector<double>& baseline, const std::vector<double>& samples, double alpha, double threshold){
+				Comparison result;
+				if(baseline.empty() || samples.empty()) return result;
+				std::vector<double> sorted(baseline);
+				result.baseline_median = Statistics::of(sorted).median;
+				sorted = samples;
+				result.current_median = Statistics::of(sorted).median;
+				result.change = result.baseline_median>0 ? result.current_median/result.baseline_median-1 : 0;
+				result.p_value = mann_whitney(baseline, samples);
+				result.verdict = Comparison::unchanged;
+				if(result.p_value<alpha && std::abs(result.change)>threshold)
+					result.verdict = result.change>0 ? Comparison::slower : Comparison::faster;
+				return result;
+			}
+		/**
+		 * Mann-Whitney U test, by the normal approximation with a correction for ties and for continuity
+		 * @returns the two-sided p-value of the hypothesis that both sets of samples come from the same distribution
+		*/
+			static double mann_whitney(const std::vector<double>& first, const std::vector<double>& second){
+				std::vector<std::pair<double, int>> all;
+				all.reserve(first.size()+second.size());
+				for(double sample : first) all.push_back(std::make_pair(sample, 0));
+				for(double sample : second) all.push_back(std::make_pair(sample, 1));
+				std::sort(all.begin(), all.end());
+				double n1 = (double)first.size(), n2 = (double)second.size(), n = n1+n2;
+				double ranks = 0, ties = 0; // sum of the ranks of the first set, sum of t^3-t over the groups of ties
+				for(std::size_t i=0;i<all.size();){
+					std::size_t j = i;
+					while(j<all.size() && all[j].first==all[i].first) j++;
+					double rank = (i+1+j)/2.0, t = (double)(j-i);
+					for(std::size_t k=i;k<j;k++) if(all[k].second==0) ranks += rank;
+					ties += t*t*t-t;
+					i = j;
+				}
+				double u = ranks-n1*(n1+1)/2, mean = n1*n2/2;
+				double variance = n1*n2/12*((n+1)-ties/(n*(n-1)));
+				if(variance<=0) return 1;
+				double z = std::max(0.0, std::abs(u-mean)-0.5)/std::sqrt(variance);
+				return std::erfc(z/std::sqrt(2.0));
+			}
+	};
+
+	/**
+	 * State of a benchmark, given to its code to control the measured loop :
+	 * while(state.keep_running()) { ... measured code ... }
+	*/
+	class State
+	{
+		private:
+			std::size_t count;
+			std::size_t remaining;
+			bool started;
+			Chrono chrono;
+			double elapsed; // ns
+			double items;
+			double bytes;
+			PerfCounters* counters; // nullptr : no performance counters
+			CounterValues counted;
+			friend class Benchmark;
+
+			State(std::size_t iterations, PerfCounters* counters)
+				: count(iterations), remaining(iterations), started(false), elapsed(0), items(0), bytes(0), counters(counters){}
+		public:
+		/**
+		 * Starts the measure on the first call, stops it on the last one
+		 * @returns true while iterations remain to run
+		*/
+			bool keep_running(){
+				if(remaining>0){
+					if(!started){
+						started=true;
+						if(counters!=nullptr) counters->start();
+						chrono.start();
+					}
+					remaining--;
+					return true;
+				}
+				chrono.stop();
+				elapsed += chrono.time()*1000000.0;
+				if(counters!=nullptr) counted += counters->stop();
+				return false;
+			}
+		/**
+		 * @returns the number of iterations of the measured loop
+		*/
+			std::size_t iterations() const { return count; }
+		/**
+		 * Stops the measure (for some code which must not be measured)
+		*/
+			void pause_timing(){
+				chrono.stop();
+				elapsed += chrono.time()*1000000.0;
+				if(counters!=nullptr) counted += counters->stop();
+			}
+		/**
+		 * Restarts the measure after pause_timing()
+		*/
+			void resume_timing(){
+				if(counters!=nullptr) counters->start();
+				chrono.start();
+			}
+		/**
+		 * Declares the number of items processed by each iteration, to report a throughput in items/s
+		*/
+			void set_items_per_iteration(double value){ items = value; }
+		/**
+		 * Declares the number of bytes processed by each iteration, to report a throughput in bytes/s
+		*/
+			void set_bytes_per_iteration(double value){ bytes = value; }
 	};
+
+	/**
+	 * Micro benchmark, the counterpart of Test for performance measures.
+	 * To create a benchmark, you must inherit this class and overrides bench_code.
+	 * The number of iterations is grown until the measure of a sample lasts much longer than the
+	 * resolution of the clock ; after some warm-up runs, samples are measured and their statistics
+	 * (in nanoseconds per operation) are sent to the output stream.
+	*/
+	class Benchmark
+	{
+		private:
+			std::ostream* output;
+			std::size_t sample_count;
+			std::size_t warmup_count;
+			double sample_time; // minimum duration of a sample, in ns
+			std::size_t iterations;
+			std::vector<double> samples; // ns per operation
+			Statistics stats;
+			double items;
+			double bytes;
+			BaselineStore* baseline;
+			BaselineStore::Comparison comparison;
+			bool perf_counters;
+			PerfCounters* counters; // opened by run() when perf_counters is set
+			CounterValues counted; // over the measured samples
+
+			// runs the code once with the given iterations, returns the ns per operation
+			double measure(std::size_t count){
+				State state(count, counters);
+				bench_code(state);
+				items = state.items;
+				bytes = state.bytes;
+				counted += state.counted;
+				return state.elapsed;
+			}
+			void calibrate(){
+				double target = std::max(sample_time, clock_resolution()*1000);
+				iterations = 1;
+				for(;;){
+					double elapsed = measure(iterations);
+					if(elapsed>=target || iterations>=(std::size_t(1)<<40)) break;
+					double factor = elapsed<=0 ? 10 : std::min(10.0, std::max(1.5, 1.2*target/elapsed));
+					iterations = (std::size_t)std::ceil(iterations*factor);
+				}
+			}
+		public:
+		/**
+		 * Initialize the benchmark.
+		 * @param output the stream to output the results (default : the standard output)
+		 * @param samples the number of measured samples (default : 30)
+		 * @param sample_time the minimum duration of a sample, in milliseconds (default : 5ms)
+		 * @param warmup the number of runs before the measures (default : 3)
+		*/
+			Benchmark(std::ostream& output=std::cout, std::size_t samples=30, double sample_time=5, std::size_t warmup=3)
+				: output(&output), sample_count(samples==0?1:samples), warmup_count(warmup),
+				  sample_time(sample_time*1000000.0), iterations(0), items(0), bytes(0), baseline(nullptr),
+				  perf_counters(false), counters(nullptr){}
+			virtual ~Benchmark(){}
+		/**
+		 * @returns the resolution of the clock used by Chrono, in nanoseconds
+		*/
+			static double clock_resolution(){
+				static const double resolution = [](){
+					unsigned long long best = ~0ull;
+					for(int i=0;i<100;i++){
+						unsigned long long start = Clock::ticks(), stop;
+						do stop = Clock::ticks(); while(stop==start);
+						best = std::min(best, stop-start);
+					}
+					return Clock::to_ns(best);
+				}();
+				return resolution;
+			}
+		/**
+		 * Runs the benchmark and outputs the results on the stream
+		*/
+			void run(){
+				(*output) << "Start of benchmark.\r\n";
+				std::unique_ptr<PerfCounters> counters_of_thread(perf_counters ? new PerfCounters() : nullptr);
+				counters = counters_of_thread.get();
+				calibrate();
+				for(std::size_t i=0;i<warmup_count;i++) measure(iterations);
+				counted = CounterValues();
+				samples.clear();
+				for(std::size_t i=0;i<sample_count;i++)
+					samples.push_back(measure(iterations)/iterations);
+				counters = nullptr;
+				std::vector<double> sorted(samples);
+				stats = Statistics::of(sorted);
+				(*output) << "Benchmark ended. "<<sample_count<<" samples of "<<iterations<<" iterations.\r\n";
+				(*output) << "Time per operation (ns) : min "<<stats.min<<", median "<<stats.median<<", mean "<<stats.mean
+					<<", p99 "<<stats.p99<<", MAD "<<stats.mad<<".\r\n";
+				if(items>0 || bytes>0){
+					(*output) << "Throughput :";
+					if(items>0) (*output) << " "<<items*1e9/stats.median<<" items/s";
+					if(bytes>0) (*output) << (items>0?", ":" ")<<bytes*1e9/stats.median<<" bytes/s";
+					(*output) << ".\r\n";
+				}
+				if(perf_counters){
+					if(counted.any()) (*output) << "Counters : " << counted.describe((double)sample_count*iterations) << "\r\n";
+					else (*output) << "Counters : not available (see perf_event_paranoid).\r\n";
+				}
+				if(baseline==nullptr) return;
+				comparison = baseline->check(name(), samples);
+				(*output) << "Baseline : " << describe(comparison) << "\r\n";
+			}
+		/**
+		 * Sets the store of the baselines : the samples of each run are recorded, or compared to the baseline
+		 * @param store the store, which must live until the end of run() (nullptr : no baseline)
+		*/
+			void set_baseline(BaselineStore* store) { baseline = store; }
+		/**
+		 * Reads the performance counters of the thread around each sample (see PerfCounters) : the results
+		 * show the instructions per cycle, and the cycles, instructions, misses and faults per operation.
+		*/
+			void set_perf_counters(bool enabled) { perf_counters = enabled; }
+		/**
+		 * @returns the performance counters summed over the samples of the last run
+		*/
+			const CounterValues& counter_values() const { return counted; }
+		/**
+		 * @returns the comparison of the last run with its baseline
+		*/
+			const BaselineStore::Comparison& baseline_comparison() const { return comparison; }
+		/**
+		 * @returns true if the last run is significantly slower than its baseline
+		*/
+			bool regressed() const { return comparison.verdict==BaselineStore::Comparison::slower; }
+		/**
+		 * @returns a comparison as a text : "slower by 12.5% (median 110 ns against 98 ns, p-value 0.0001)."
+		*/
+			static std::string describe(const BaselineStore::Comparison& comparison){
+				static const char* const verdicts[] = { "recorded or missing", "unchanged", "faster", "slower" };
+				std::ostringstream text;
+				text << verdicts[comparison.verdict];
+				if(comparison.verdict!=BaselineStore::Comparison::unchanged && comparison.verdict!=BaselineStore::Comparison::missing)
+					text << " by " << std::abs(comparison.change)*100 << '%';
+				if(comparison.verdict!=BaselineStore::Comparison::missing)
+					text << " (median " << comparison.current_median << " ns against " << comparison.baseline_median
+						<< " ns, p-value " << comparison.p_value << ")";
+				text << '.';
+				return text.str();
+			}
+		/**
+		 * @returns the statistics of the last run, in nanoseconds per operation
+		*/
+			const Statistics& statistics() const { return stats; }
+		/**
+		 * @returns the samples of the last run, in nanoseconds per operation (in order of measure)
+		*/
+			const std::vector<double>& sample_values() const { return samples; }
+		/**
+		 * @returns the number of iterations of each sample of the last run
+		*/
+			std::size_t iterations_per_sample() const { return iterations; }
+		/**
+		 * Name of the benchmark, used in reports.
+		 * Override it to give a readable name (default : the name of the dynamic type, "benchmark" without RTTI)
+		*/
+			virtual std::string name() const {
+#if defined(TESTS_RTTI)
+				return demangle(typeid(*this).name());
+#else
+				return "benchmark";
+#endif
+			}
+		protected:
+		/**
+		 * Contains the code of the benchmark : the measured code must be in a loop
+		 * while(state.keep_running()) { ... }
+		 * @param state the state of the benchmark
+		*/
+			virtual void bench_code(State& state) = 0;
+	};
+
+	// performance assertions of the tests : in the header-only mode, or compiled once by test.cpp
+#if !defined(TESTS_SEPARATE_COMPILATION) || defined(TESTS_IMPLEMENTATION)
+	TESTS_INLINE void Test::check_time(double budget, Timed timed, Name name){
+		// the batches last at least 1 ms, so the resolution of the clock does not matter
+		std::size_t iterations = 1;
+		for(;;){
+			unsigned long long start = Clock::ticks();
+			timed.run(timed.code, iterations);
+			double elapsed = Clock::to_ns(Clock::ticks()-start);
+			check_timeout();
+			if(elapsed>=1000000.0 || iterations>=((std::size_t)1<<40)) break;
+			iterations *= elapsed<100000.0 ? 10 : 2;
+		}
+		std::vector<double> samples;
+		unsigned long long begin = Clock::ticks();
+		while(samples.size()<21 && (samples.size()<5 || Clock::to_ns(Clock::ticks()-begin)<1e9)){
+			unsigned long long start = Clock::ticks();
+			timed.run(timed.code, iterations);
+			samples.push_back(Clock::to_ns(Clock::ticks()-start)/iterations);
+			check_timeout();
+		}
+		BaselineStore::Comparison comparison;
+		if(baseline!=nullptr) comparison = baseline->check(stored_name()+"/"+name.str(), samples);
+		Statistics statistics = Statistics::of(samples);
+		if(comparison.verdict==BaselineStore::Comparison::slower){
+			fails(name, ("slower than the baseline : "+Benchmark::describe(comparison)).c_str());
+			return;
+		}
+		if(statistics.median<=budget){
+			passes(name);
+			return;
+		}
+		failed++;
+		print_result(name,false);
+		std::ostringstream text;
+		text << "median of " << statistics.median << " ns per call but at most " << budget << " ns expected ("
+			<< statistics.count << " batches of " << iterations << " calls, min " << statistics.min << " ns, MAD " << statistics.mad << " ns).";
+		print_message(text.str());
+	}
+
+	TESTS_INLINE void Test::check_complexity(Complexity expected, Scaled scaled, Name name){
+		static const char* const names[] = { "O(1)", "O(log n)", "O(n)", "O(n log n)", "O(n^2)", "O(n^3)" };
+		const int classes = 6;
+		const double cheap_call = 1000; // ns : cheaper calls are repeated on one input in the cache
+		const double noise = 0.2; // maximum relative error of the best fit, above it the times tell no class
+		std::vector<double> sizes, times;
+		std::vector<std::size_t> counts;
+		bool warm = false;
+		// time of a call on inputs of a size : cheap code runs on one input in the cache, as on distinct inputs
+		// its time would be the one of their cache misses, other code runs once on each of distinct inputs
+		auto measure = [&](std::size_t size, std::size_t count){
+			void* inputs = scaled.prepare(scaled.context, size, warm ? 1 : count);
+			if(warm) scaled.run(scaled.context, inputs);
+			unsigned long long start = Clock::ticks();
+			if(warm) for(std::size_t i=0;i<count;i++) scaled.run(scaled.context, inputs);
+			else scaled.run(scaled.context, inputs);
+			double time = Clock::to_ns(Clock::ticks()-start)/count;
+			scaled.release(inputs);
+			check_timeout();
+			return time;
+		};
+		unsigned long long begin = Clock::ticks();
+		for(std::size_t size=std::max<std::size_t>(complexity_first,1);size<=complexity_last;size*=2){
+			// one call estimates how many calls make a measure of 20 us
+			void* inputs = scaled.prepare(scaled.context, size, 1);
+			unsigned long long start = Clock::ticks();
+			scaled.run(scaled.context, inputs);
+			double estimate = Clock::to_ns(Clock::ticks()-start);
+			if(sizes.empty()) warm = estimate<cheap_call;
+			std::size_t count = (std::size_t)std::min(1000.0, std::max(1.0, 20000.0/std::max(estimate,1.0)));
+			// the first call of cheap code is mostly cache misses : its repeated calls are timed instead
+			if(warm)
+				for(count=1;count<1000000;count*=2){
+					start = Clock::ticks();
+					for(std::size_t i=0;i<count;i++) scaled.run(scaled.context, inputs);
+					if(Clock::to_ns(Clock::ticks()-start)>=20000) break;
+				}
+			scaled.release(inputs);
+			counts.push_back(count);
+			sizes.push_back((double)size);
+			times.push_back(measure(size, counts.back()));
+			if(times.back()>50000000.0 || (Clock::to_ns(Clock::ticks()-begin)>6e8 && sizes.size()>=4)) break;
+		}
+		// 4 more rounds over all the sizes : a load of the machine slows a round down rather than a size,
+		// and it only slows the code down, so the fastest time of a size is its least disturbed one
+		for(int round=1;round<5;round++)
+			for(std::size_t i=0;i<sizes.size();i++) times[i] = std::min(times[i], measure((std::size_t)sizes[i], counts[i]));
+		if(sizes.size()<4){
+			fails(name, "not enough sizes measured : less than 4 (see set_complexity_sizes).");
+			return;
+		}
+		auto print_times = [&](){
+			std::ostringstream text;
+			text << "\tfastest times (ns) :";
+			for(std::size_t i=0;i<sizes.size();i++) text << ' ' << (std::size_t)sizes[i] << ':' << times[i];
+			print_message(text.str());
+		};
+		// fits t = a + c.f(n) for each class, by least squares on the relative errors
+		double errors[classes];
+		double best_error = -1;
+		for(int k=0;k<classes;k++){
+			double sw=0, sf=0, sff=0, st=0, sft=0;
+			for(std::size_t i=0;i<sizes.size();i++){
+				double n = sizes[i], l = std::log2(n);
+				double f = k==0 ? 0 : k==1 ? l : k==2 ? n : k==3 ? n*l : k==4 ? n*n : n*n*n;
+				double w = 1/(times[i]*times[i]);
+				sw += w; sf += w*f; sff += w*f*f; st += w*times[i]; sft += w*f*times[i];
+			}
+			double determinant = sw*sff-sf*sf;
+			double c = determinant>0 ? (sw*sft-sf*st)/determinant : 0;
+			if(c<0) c = 0;
+			double a = (st-c*sf)/sw;
+			double error = 0;
+			for(std::size_t i=0;i<sizes.size();i++){
+				double n = sizes[i], l = std::log2(n);
+				double f = k==0 ? 0 : k==1 ? l : k==2 ? n : k==3 ? n*l : k==4 ? n*n : n*n*n;
+				double relative = (times[i]-(a+c*f))/times[i];
+				error += relative*relative;
+			}
+			errors[k] = std::sqrt(error/sizes.size());
+			if(best_error<0 || errors[k]<best_error) best_error = errors[k];
+		}
+		// no class fits the times : they are too noisy to tell a class, and a regression must not pass unseen
+		if(best_error>noise){
+			failed++;
+			print_result(name,false);
+			std::ostringstream text;
+			text << "complexity is inconclusive : the best fit has a relative error of " << best_error << " (at most " << noise
+				<< " needed), the machine may be too loaded. Relative errors of the fits :";
+			for(int k=0;k<classes;k++) text << ' ' << names[k] << ' ' << errors[k];
+			print_message(text.str());
+			print_times();
+			return;
+		}
+		// the simplest class which fits about as well as the best one : noise does not make a class worse
+		int found = 0;
+		while(errors[found]>std::max(1.5*best_error, best_error+0.05)) found++;
+		if(found<=(int)expected){
+			passes(name);
+			return;
+		}
+		failed++;
+		print_result(name,false);
+		std::ostringstream text;
+		text << "complexity is " << names[found] << " but " << names[expected] << " expected. Relative errors of the fits :";
+		for(int k=0;k<classes;k++) text << ' ' << names[k] << ' ' << errors[k];
+		print_message(text.str());
+		print_times();
+	}
+
+	/**
+	 * Spins a little : tells the processor the thread is waiting
+	*/
+	inline void spin_pause(){
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+		_mm_pause();
+#endif
+	}
+
+	/**
+	 * Barrier of a fixed number of threads, which spin while they wait, so they are released together
+	 * (they yield after a while, when there are more threads than cores)
+	*/
+	class SpinBarrier
+	{
+		private:
+			const unsigned count;
+			std::atomic<unsigned> waiting;
+			std::atomic<unsigned> generation;
+		public:
+			explicit SpinBarrier(unsigned count) : count(count), waiting(0), generation(0){}
+		/**
+		 * Waits until all the threads have arrived
+		*/
+			void arrive_and_wait(){
+				unsigned current = generation.load(std::memory_order_acquire);
+				if(waiting.fetch_add(1, std::memory_order_acq_rel)+1==count){
+					waiting.store(0, std::memory_order_relaxed);
+					generation.fetch_add(1, std::memory_order_release);
+					return;
+				}
+				for(unsigned spins=0;generation.load(std::memory_order_acquire)==current;spins++){
+					if(spins<(1u<<14)) spin_pause();
+					else std::this_thread::yield();
+				}
+			}
+	};
+
+	// state of the perturbations of the thread, while it runs the code of a stress
+	struct StressPerturbation
+	{
+		Random random;
+		std::uint64_t threshold; // a perturbation when the 53 high bits of a random number are below
+		bool active;
+	};
+	TESTS_INLINE StressPerturbation& stress_perturbation_of_thread(){
+		static thread_local StressPerturbation state = { Random(), 0, false };
+		return state;
+	}
+	TESTS_INLINE void stress_point(){
+		StressPerturbation& state = stress_perturbation_of_thread();
+		if(!state.active) return;
+		std::uint64_t drawn = state.random.next();
+		if((drawn>>11)>=state.threshold) return;
+		if(drawn & 1) std::this_thread::yield();
+		else for(unsigned spins=(unsigned)((drawn>>1)%1024);spins>0;spins--) spin_pause();
+	}
+
+	TESTS_INLINE void Test::check_stress(unsigned threads, std::uint64_t iterations, Stressed stressed, Name name){
+		if(threads==0) threads = std::max(1u, std::thread::hardware_concurrency());
+		std::uint64_t seed = stress_seed;
+		while(seed==0){
+			std::uint64_t x = Clock::ticks() ^ (std::uint64_t)std::chrono::system_clock::now().time_since_epoch().count();
+			seed = Random::mix(x);
+		}
+		const unsigned rounds = std::max(1u, stress_rounds);
+		const std::uint64_t threshold = (std::uint64_t)(std::min(1.0, std::max(0.0, stress_perturbation))*9007199254740992.0);
+		std::vector<int> cores; // the cores allowed to the process, to pin the threads
+#if defined(__linux__)
+		cpu_set_t allowed;
+		if(stress_pinned && sched_getaffinity(0, sizeof(allowed), &allowed)==0)
+			for(int core=0;core<CPU_SETSIZE;core++) if(CPU_ISSET(core, &allowed)) cores.push_back(core);
+#endif
+		std::vector<unsigned> counts;
+		for(unsigned count=1;count<threads;count*=2) counts.push_back(count);
+		counts.push_back(threads);
+		std::vector<std::string> curve;
+		std::ostringstream failure;
+		double single = 0; // ops/s of a single thread
+		for(unsigned count : counts){
+			SpinBarrier barrier(count+1);
+			std::atomic<bool> stop(false);
+			std::vector<double> busy(count, 0); // ns
+			std::vector<std::uint64_t> calls(count, 0); // run by each thread : a timeout or an exception ends its rounds early
+			std::vector<std::exception_ptr> errors(count);
+			std::vector<std::thread> workers;
+			unsigned round = 0;
+			for(unsigned t=0;t<count;t++) workers.emplace_back([&, t](){
+#if defined(__linux__)
+				if(!cores.empty()){
+					cpu_set_t core;
+					CPU_ZERO(&core);
+					CPU_SET(cores[t%cores.size()], &core);
+					pthread_setaffinity_np(pthread_self(), sizeof(core), &core);
+				}
+#endif
+				StressPerturbation& state = stress_perturbation_of_thread();
+				for(;;){
+					barrier.arrive_and_wait();
+					if(stop.load(std::memory_order_acquire)) return;
+					std::uint64_t x = seed ^ ((std::uint64_t)count<<48) ^ ((std::uint64_t)t<<24) ^ round;
+					state.random = Random(Random::mix(x));
+					state.threshold = threshold;
+					state.active = true;
+					unsigned long long start = Clock::ticks();
+					std::uint64_t i = 0;
+					try{
+						for(;i<iterations && !timed_out.load(std::memory_order_relaxed);i++) stressed.run(stressed.code, t, i);
+					}
+					catch(...){
+						errors[t] = std::current_exception();
+					}
+					busy[t] += Clock::to_ns(Clock::ticks()-start);
+					calls[t] += i;
+					state.active = false;
+					barrier.arrive_and_wait();
+				}
+			});
+			for(;round<rounds && !timed_out;round++){
+				barrier.arrive_and_wait(); // releases the threads
+				barrier.arrive_and_wait(); // they have ended the round
+				for(unsigned t=0;t<count && failure.tellp()==0;t++){
+					if(!errors[t]) continue;
+					failure << "an exception is thrown by the thread " << t;
+					try{
+						std::rethrow_exception(errors[t]);
+					}
+					catch(const std::exception& exception){
+						failure << " (" << exception.what() << ")";
+					}
+					catch(...){}
+				}
+				if(failure.tellp()==0 && stressed.holds!=nullptr){
+					bool holds = false;
+					try{
+						holds = stressed.holds(stressed.invariant);
+					}
+					catch(...){}
+					if(!holds) failure << "the invariant does not hold";
+				}
+				if(failure.tellp()>0){
+					failure << " in the round " << round+1 << " of " << count << (count>1 ? " threads" : " thread");
+					round++;
+					break;
+				}
+			}
+			stop.store(true, std::memory_order_release);
+			barrier.arrive_and_wait();
+			for(std::thread& worker : workers) worker.join();
+			check_timeout();
+			// throughput : the calls of each thread over the time it has run them
+			double total = 0;
+			for(unsigned t=0;t<count;t++) if(busy[t]>0) total += calls[t]/busy[t]*1e9;
+			if(count==1) single = total;
+			std::ostringstream line;
+			line << "\t" << count << (count>1 ? " threads : " : " thread : ") << total/count << " ops/s per thread, " << total << " ops/s";
+			if(count>1 && single>0) line << ", efficiency " << total/(single*count)*100 << "%";
+			line << '.';
+			curve.push_back(line.str());
+			if(failure.tellp()>0) break;
+		}
+		if(failure.tellp()==0) passes(name);
+		else{
+			failed++;
+			print_result(name,false);
+			failure << ", replay with set_stress_seed(" << seed << ").";
+			print_message(failure.str());
+		}
+		if(verbosity==all || failure.tellp()>0)
+			for(const std::string& line : curve) print_message(line);
+	}
+#endif
+
+#if defined(TESTS_COROUTINES)
+	class AsyncTest;
+	template <typename T=void> class Task;
+
+	/**
+	 * The promise of a task : the coroutine starts when it is awaited, and resumes its caller when it ends
+	*/
+	struct TaskPromiseBase
+	{
+		std::coroutine_handle<> continuation;
+		std::exception_ptr exception;
+
+		struct Final
+		{
+			bool await_ready() noexcept { return false; }
+			template <typename promise>
+			std::coroutine_handle<> await_suspend(std::coroutine_handle<promise> ending) noexcept {
+				std::coroutine_handle<> next = ending.promise().continuation;
+				return next ? next : std::noop_coroutine();
+			}
+			void await_resume() noexcept {}
+		};
+		std::suspend_always initial_suspend() noexcept { return {}; }
+		Final final_suspend() noexcept { return {}; }
+		void unhandled_exception() { exception = std::current_exception(); }
+		void rethrow() { if(exception) std::rethrow_exception(exception); }
+	};
+	template <typename T>
+	struct TaskPromise : TaskPromiseBase
+	{
+		std::optional<T> value;
+		void return_value(T result) { value.emplace(std::move(result)); }
+		T result(){
+			rethrow();
+			return std::move(*value);
+		}
+	};
+	template <>
+	struct TaskPromise<void> : TaskPromiseBase
+	{
+		void return_void() {}
+		void result() { rethrow(); }
+	};
+
+	/**
+	 * A coroutine which returns a value of type T (see AsyncTest) : it runs when it is awaited,
+	 * and the exceptions it throws are thrown again to the coroutine which awaits it.
+	*/
+	template <typename T>
+	class Task
+	{
+		public:
+			struct promise_type : TaskPromise<T>
+			{
+				Task get_return_object() { return Task(std::coroutine_handle<promise_type>::from_promise(*this)); }
+			};
+		private:
+			std::coroutine_handle<promise_type> handle;
+			explicit Task(std::coroutine_handle<promise_type> handle) : handle(handle){}
+			friend class EventLoop;
+		public:
+			Task(Task&& other) noexcept : handle(std::exchange(other.handle, nullptr)){}
+			Task& operator=(Task&& other) noexcept {
+				if(this!=&other){
+					if(handle) handle.destroy();
+					handle = std::exchange(other.handle, nullptr);
+				}
+				return *this;
+			}
+			~Task(){
+				if(handle) handle.destroy();
+			}
+		/**
+		 * @returns true if the coroutine has ended
+		*/
+			bool done() const { return !handle || handle.done(); }
+			bool await_ready() const noexcept { return done(); }
+			std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept {
+				handle.promise().continuation = awaiting;
+				return handle;
+			}
+			T await_resume() { return handle.promise().result(); }
+	};
+
+	/**
+	 * A coroutine suspended by the event loop, until a file descriptor is ready or a deadline
+	*/
+	struct Waiter
+	{
+		std::coroutine_handle<> handle;
+		AsyncTest* test; // the test which runs the coroutine
+		int fd; // -1 : a timer only
+		std::uint32_t events; // EPOLLIN, EPOLLOUT
+		std::uint64_t timer; // 0 : no deadline
+		bool expired; // resumed by its deadline
+		int error; // errno of epoll when the file descriptor can't be watched, 0 : none
+	};
+
+	/**
+	 * Single threaded event loop of the coroutine tests : it resumes the coroutines whose file descriptors are
+	 * ready (epoll) or whose deadlines are over (a heap of timers), so the waits of many tests overlap.
+	 * Each wait is bounded by the timeout of its test : then the coroutine throws Timeout when it is resumed.
+	*/
+	class EventLoop
+	{
+		private:
+			struct Ready
+			{
+				std::coroutine_handle<> handle;
+				AsyncTest* test;
+			};
+			// waiters of a file descriptor : it is registered once in epoll, for the events they wait for
+			struct Watch
+			{
+				std::deque<Waiter*> readers;
+				std::deque<Waiter*> writers;
+				std::uint32_t events; // registered in epoll, 0 : not registered
+			};
+			typedef std::pair<std::uint64_t, std::uint64_t> Deadline; // time in ns, timer
+			int poller;
+			std::deque<Ready> ready;
+			std::priority_queue<Deadline, std::vector<Deadline>, std::greater<Deadline>> deadlines;
+			std::unordered_map<std::uint64_t, Waiter*> timers; // armed timers, cancelled ones are not there
+			std::unordered_map<int, Watch> watches;
+			std::size_t watched; // waiters of file descriptors
+			std::uint64_t last_timer;
+			std::vector<Task<>> spawned;
+			std::size_t collected; // number of spawned tasks after the last collection of the ended ones
+			AsyncTest* running; // test of the running coroutine
+			EventLoop* previous;
+			friend class AsyncTest;
+
+			static EventLoop*& instance(){
+				static thread_local EventLoop* loop = nullptr;
+				return loop;
+			}
+			static std::deque<Waiter*>& queue_of(Watch& watch, const Waiter& waiter){
+				return (waiter.events & EPOLLIN)!=0 ? watch.readers : watch.writers;
+			}
+			// registers the events waited for on a file descriptor : added, modified or deleted in epoll
+			// @returns 0, or the errno of epoll_ctl
+			int update(int fd, Watch& watch){
+				std::uint32_t events = (watch.readers.empty() ? 0u : (std::uint32_t)EPOLLIN) | (watch.writers.empty() ? 0u : (std::uint32_t)EPOLLOUT);
+				if(events==watch.events) return 0;
+				if(events==0){
+					epoll_ctl(poller, EPOLL_CTL_DEL, fd, nullptr); // fails when the file descriptor is closed : it is not registered any more
+					watch.events = 0;
+					return 0;
+				}
+				epoll_event event;
+				event.events = events;
+				event.data.fd = fd;
+				if(epoll_ctl(poller, watch.events==0 ? EPOLL_CTL_ADD : EPOLL_CTL_MOD, fd, &event)!=0) return errno;
+				watch.events = events;
+				return 0;
+			}
+			// removes a waiter of a file descriptor, whose deadline is over
+			void unwatch(Waiter& waiter){
+				if(waiter.fd<0) return;
+				std::unordered_map<int, Watch>::iterator found = watches.find(waiter.fd);
+				std::deque<Waiter*>& queue = queue_of(found->second, waiter);
+				queue.erase(std::find(queue.begin(), queue.end(), &waiter));
+				update(waiter.fd, found->second);
+				if(found->second.events==0) watches.erase(found);
+				watched--;
+			}
+			// resumes the first waiter of a queue, whose file descriptor is ready
+			void wake(std::deque<Waiter*>& queue){
+				Waiter& waiter = *queue.front();
+				queue.pop_front();
+				watched--;
+				if(waiter.timer!=0) timers.erase(waiter.timer);
+				schedule(waiter.handle, waiter.test);
+			}
+			inline std::uint64_t deadline_of(AsyncTest* test) const;
+		public:
+			EventLoop() : poller(epoll_create1(EPOLL_CLOEXEC)), watched(0), last_timer(0), collected(0), running(nullptr), previous(instance()){
+				if(poller<0) throw std::runtime_error("tests::EventLoop : epoll_create1 failed");
+				instance() = this;
+			}
+			~EventLoop(){
+				spawned.clear();
+				close(poller);
+				instance() = previous;
+			}
+			EventLoop(const EventLoop&) = delete;
+			EventLoop& operator=(const EventLoop&) = delete;
+		/**
+		 * @returns the event loop of the thread
+		 * @throws std::logic_error if the thread runs no event loop
+		*/
+			static EventLoop& current(){
+				if(instance()==nullptr) throw std::logic_error("tests::EventLoop : no event loop runs on this thread");
+				return *instance();
+			}
+		/**
+		 * @returns the time of the loop, in nanoseconds
+		*/
+			static std::uint64_t now(){
+				return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+			}
+		/**
+		 * @returns the test of the running coroutine (nullptr outside of a test)
+		*/
+			AsyncTest* running_test() const { return running; }
+		/**
+		 * Schedules a coroutine, which is resumed by the next turn of the loop
+		*/
+			void schedule(std::coroutine_handle<> handle, AsyncTest* test){
+				ready.push_back(Ready{ handle, test });
+			}
+		/**
+		 * Starts a task on the loop, which keeps it until it ends : the task runs concurrently with its caller,
+		 * for the same test. Its exceptions are lost : catch them in the task (see when_all).
+		*/
+			void spawn(Task<> task){
+				schedule(task.handle, running);
+				spawned.push_back(std::move(task));
+			}
+		/**
+		 * Suspends a coroutine until its file descriptor is ready, or its deadline (bounded by the timeout of its test)
+		 * @param waiter the waiter, which lives in the suspended coroutine
+		 * @param deadline the deadline, in ns (see now()), ~0 : none
+		*/
+			void suspend(Waiter& waiter, std::uint64_t deadline){
+				waiter.test = running;
+				waiter.timer = 0;
+				waiter.expired = false;
+				waiter.error = 0;
+				if(waiter.fd>=0){
+					Watch& watch = watches[waiter.fd];
+					std::deque<Waiter*>& queue = queue_of(watch, waiter);
+					queue.push_back(&waiter);
+					int error = update(waiter.fd, watch);
+					if(error!=0){
+						queue.pop_back();
+						if(watch.events==0) watches.erase(waiter.fd);
+						// regular files can't be watched (EPERM) : they are always ready. Other errors are thrown by the wait
+						if(error!=EPERM) waiter.error = error;
+						waiter.fd = -1;
+						schedule(waiter.handle, waiter.test);
+						return;
+					}
+					watched++;
+				}
+				deadline = std::min(deadline, deadline_of(running));
+				if(deadline!=~0ull){
+					waiter.timer = ++last_timer;
+					timers[waiter.timer] = &waiter;
+					deadlines.push(Deadline(deadline, waiter.timer));
+				}
+			}
+		/**
+		 * Runs the coroutines until none can be resumed any more
+		*/
+			void run(){
+				std::vector<epoll_event> events(64);
+				while(!ready.empty() || !timers.empty() || watched>0){
+					while(!ready.empty()){
+						Ready next = ready.front();
+						ready.pop_front();
+						running = next.test;
+						next.handle.resume();
+						running = nullptr;
+					}
+					if(spawned.size()>=2*collected+64){
+						spawned.erase(std::remove_if(spawned.begin(), spawned.end(), [](const Task<>& task){ return task.done(); }), spawned.end());
+						collected = spawned.size();
+					}
+					if(timers.empty() && watched==0) break;
+					while(!deadlines.empty() && timers.find(deadlines.top().second)==timers.end()) deadlines.pop();
+					int wait = -1;
+					if(!deadlines.empty()){
+						std::uint64_t time = now(), next = deadlines.top().first;
+						wait = next<=time ? 0 : (int)std::min<std::uint64_t>((next-time+999999)/1000000, 1000000);
+					}
+					int count = epoll_wait(poller, events.data(), (int)events.size(), wait);
+					for(int i=0;i<count;i++){
+						std::unordered_map<int, Watch>::iterator found = watches.find(events[i].data.fd);
+						if(found==watches.end()) continue;
+						// one reader and one writer are resumed : the next ones wait until the file descriptor is ready again,
+						// as the first ones may have read or written all it could (errors and hang-ups resume both)
+						Watch& watch = found->second;
+						bool failed = (events[i].events & (EPOLLERR | EPOLLHUP))!=0;
+						if(!watch.readers.empty() && ((events[i].events & EPOLLIN)!=0 || failed)) wake(watch.readers);
+						if(!watch.writers.empty() && ((events[i].events & EPOLLOUT)!=0 || failed)) wake(watch.writers);
+						update(found->first, watch);
+						if(watch.events==0) watches.erase(found);
+					}
+					std::uint64_t time = now();
+					while(!deadlines.empty() && deadlines.top().first<=time){
+						std::unordered_map<std::uint64_t, Waiter*>::iterator found = timers.find(deadlines.top().second);
+						deadlines.pop();
+						if(found==timers.end()) continue;
+						Waiter& waiter = *found->second;
+						timers.erase(found);
+						unwatch(waiter);
+						waiter.expired = true;
+						schedule(waiter.handle, waiter.test);
+					}
+				}
+			}
+		/**
+		 * Runs a task on the loop until it ends (or until no coroutine can be resumed)
+		 * @returns true if the task has ended
+		*/
+			bool run(Task<>& task){
+				schedule(task.handle, running);
+				run();
+				return task.done();
+			}
+	};
+
+	/**
+	 * Awaitable of the event loop : a file descriptor to be ready, or a deadline
+	*/
+	class Wait
+	{
+		private:
+			Waiter waiter;
+			std::uint64_t deadline;
+		public:
+			Wait(int fd, std::uint32_t events, std::uint64_t deadline) : deadline(deadline){
+				waiter.fd = fd;
+				waiter.events = events;
+				waiter.test = nullptr;
+				waiter.timer = 0;
+				waiter.expired = false;
+				waiter.error = 0;
+			}
+			bool await_ready() const noexcept { return false; }
+			void await_suspend(std::coroutine_handle<> handle){
+				waiter.handle = handle;
+				EventLoop::current().suspend(waiter, deadline);
+			}
+			inline bool await_resume();
+	};
+
+	/**
+	 * @param duration a duration
+	 * @returns the deadline after a duration, for the awaitables of the event loop (~0 : none)
+	*/
+	template <typename representation, typename period>
+	std::uint64_t deadline_after(std::chrono::duration<representation, period> duration){
+		if(duration==std::chrono::duration<representation, period>::max()) return ~0ull;
+		return EventLoop::now()+std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count();
+	}
+	/**
+	 * Suspends the coroutine during a duration : co_await tests::sleep_for(std::chrono::milliseconds(10));
+	*/
+	template <typename representation, typename period>
+	Wait sleep_for(std::chrono::duration<representation, period> duration){
+		return Wait(-1, 0, deadline_after(duration));
+	}
+	/**
+	 * Suspends the coroutine until a file descriptor can be read : bool ready = co_await tests::readable(fd, 100ms);
+	 * When several coroutines wait for the same file descriptor, each time it is ready one reader and one writer
+	 * are resumed, in the order of their waits : the others wait until it is ready again. A regular file is always
+	 * ready, and a file descriptor which can't be watched (closed...) makes the wait throw std::runtime_error.
+	 * @param fd the file descriptor
+	 * @param timeout the maximum duration of the wait (default : the timeout of the test)
+	 * @returns an awaitable whose result is true if the file descriptor is ready, false if the timeout is over
+	*/
+	inline Wait readable(int fd, std::chrono::milliseconds timeout=std::chrono::milliseconds::max()){
+		return Wait(fd, EPOLLIN, deadline_after(timeout));
+	}
+	/**
+	 * Suspends the coroutine until a file descriptor can be written (see readable)
+	 * @param fd the file descriptor
+	 * @param timeout the maximum duration of the wait (default : the timeout of the test)
+	 * @returns an awaitable whose result is true if the file descriptor is ready, false if the timeout is over
+	*/
+	inline Wait writable(int fd, std::chrono::milliseconds timeout=std::chrono::milliseconds::max()){
+		return Wait(fd, EPOLLOUT, deadline_after(timeout));
+	}
+
+	/**
+	 * Tasks awaited together (see when_all)
+	*/
+	struct Join
+	{
+		std::size_t remaining;
+		std::coroutine_handle<> waiting;
+		AsyncTest* test;
+		std::exception_ptr exception; // the first exception of the tasks
+
+		bool await_ready() const noexcept { return remaining==0; }
+		void await_suspend(std::coroutine_handle<> handle) noexcept {
+			waiting = handle;
+			test = EventLoop::current().running_test();
+		}
+		void await_resume() const {}
+	};
+	inline Task<> joined(Task<> task, Join& join){
+		try{
+			co_await task;
+		}
+		catch(...){
+			if(!join.exception) join.exception = std::current_exception();
+		}
+		if(--join.remaining==0 && join.waiting) EventLoop::current().schedule(join.waiting, join.test);
+	}
+	/**
+	 * Runs child tasks concurrently, and waits until they all end : co_await tests::when_all(std::move(tasks));
+	 * @param tasks the tasks
+	 * @returns a task which throws again the first exception of the tasks, if any
+	*/
+	inline Task<> when_all(std::vector<Task<>> tasks){
+		Join join{ tasks.size(), nullptr, nullptr, nullptr };
+		for(Task<>& task : tasks) EventLoop::current().spawn(joined(std::move(task), join));
+		co_await join;
+		if(join.exception) std::rethrow_exception(join.exception);
+	}
+
+	/**
+	 * A test whose code is a coroutine, for the tests which wait (sockets, pipes, processes) :
+	 * override co_test_code() and await tests::sleep_for, tests::readable, tests::writable, tests::when_all or
+	 * other tasks. The assertions work as in test_code().
+	 * run() runs the test alone on its own event loop ; AsyncTest::run_all runs many tests on the event loop of
+	 * a single thread, so their waits overlap. The timeout of the test bounds each of its waits.
+	*/
+	class AsyncTest : public Test
+	{
+		private:
+			std::uint64_t deadline; // ns, ~0 : none
+			bool finished;
+			friend class EventLoop;
+			friend class Wait;
+
+			void start_deadline(){
+				deadline = timeout_delay==infinite ? ~0ull : EventLoop::now()+timeout_delay*1000000ull;
+			}
+			static Task<> drive(AsyncTest& test){
+				try{
+					co_await test.co_test_code();
+				}
+				catch(const Timeout&){
+					test.timed_out = false;
+					test.fail("*** timeout ***");
+				}
+				catch(...){
+					test.timed_out = false;
+					test.fail("*** exception occurs ***");
+				}
+				test.end(true);
+			}
+			// tears the test down, and writes its resume
+			void end(bool prepared){
+				if(prepared){
+					try{
+						tear_down();
+					}
+					catch(...){
+						timed_out = false;
+						fail("*** exception occurs in tear_down ***");
+					}
+				}
+				finish_execute(true);
+				end_execute();
+				finished = true;
+			}
+			// after a wait : the test times out when its deadline is over
+			void resumed(bool expired){
+				if(expired && EventLoop::now()>=deadline) timed_out = true;
+				check_timeout();
+			}
+		public:
+		/**
+		 * Initialize the test (see Test)
+		*/
+			AsyncTest(std::ostream& output=default_output(), unsigned long timeout=default_timeout)
+				: Test(output, timeout), deadline(~0ull), finished(false){}
+		/**
+		 * Runs many tests on the event loop of the calling thread : their waits overlap. Each test has its own arena,
+		 * but the allocations of the tests are counted together. A test whose coroutine is never resumed fails.
+		 * As in a suite, the tests without a reporter write into buffers, written to their streams in order at the end.
+		 * @param tests the tests
+		 * @returns the number of tests which have at least one failed assertion
+		*/
+			static int run_all(const std::vector<AsyncTest*>& tests){
+				std::vector<std::unique_ptr<Arena>> arenas;
+				std::vector<std::unique_ptr<std::ostringstream>> buffers(tests.size());
+				std::vector<std::unique_ptr<StreamReporter>> reporters(tests.size());
+				EventLoop loop;
+				for(std::size_t i=0;i<tests.size();i++){
+					AsyncTest* test = tests[i];
+					test->finished = false;
+					if(test->reporter==nullptr){
+						buffers[i].reset(new std::ostringstream());
+						reporters[i].reset(new StreamReporter(*buffers[i]));
+						test->reporter = reporters[i].get();
+					}
+					arenas.emplace_back(new Arena());
+					if(!test->start_execute(true, arenas.back().get())){
+						test->end_execute();
+						test->finished = true;
+						continue;
+					}
+					test->start_deadline();
+					try{
+						test->set_up();
+					}
+					catch(...){
+						test->timed_out = false;
+						test->fail("*** exception occurs in set_up ***");
+						test->end(false);
+						continue;
+					}
+					loop.running = test;
+					loop.spawn(drive(*test));
+					loop.running = nullptr;
+				}
+				loop.run();
+				int failures = 0;
+				for(std::size_t i=0;i<tests.size();i++){
+					AsyncTest* test = tests[i];
+					if(!test->finished){
+						test->fail("*** the coroutine is never resumed ***");
+						test->end(true);
+					}
+					if(test->failed_count()>0) failures++;
+					if(buffers[i]){
+						test->reporter = nullptr;
+						*test->output << buffers[i]->str();
+					}
+				}
+				return failures;
+			}
+		protected:
+		/**
+		 * Contains the code of the test, a coroutine
+		*/
+			virtual Task<> co_test_code() = 0;
+		/**
+		 * Runs co_test_code on an event loop of its own
+		*/
+			void test_code() override {
+				EventLoop loop;
+				start_deadline();
+				Task<> task = co_test_code();
+				loop.running = this;
+				if(!loop.run(task)) fail("*** the coroutine is never resumed ***");
+				else task.await_resume();
+			}
+	};
+
+	inline std::uint64_t EventLoop::deadline_of(AsyncTest* test) const {
+		return test==nullptr ? ~0ull : test->deadline;
+	}
+	inline bool Wait::await_resume(){
+		if(waiter.error!=0) throw std::runtime_error(std::string("tests::EventLoop : the file descriptor can't be watched, ")+std::strerror(waiter.error));
+		if(waiter.test!=nullptr) waiter.test->resumed(waiter.expired);
+		return !waiter.expired;
+	}
+#endif
+}
+
+/**
+ * Defines the fuzz target LLVMFuzzerTestOneInput of a test class (which must have a default constructor) :
+ * each input is given to its fuzz_code function, and a failed assertion aborts the process.
+ * Built with -fsanitize=fuzzer -DFUZZING_BUILD_MODE_UNSAFE_FOR_PRODUCTION, the program is a libFuzzer fuzzer.
+ * Otherwise it is a driver which replays the files and directories given as arguments (see tests::replay_corpus).
+*/
+#define TESTS_FUZZ_TARGET(type) \
+	extern "C" int LLVMFuzzerTestOneInput(const std::uint8_t* data, std::size_t size){ \
+		static type test; \
+		test.fuzz(data, size); \
+		return 0; \
+	} \
+	TESTS_FUZZ_MAIN
+
+/**
+ * Counting of the heap allocations : defined in one file of the program (before including test.h, or when compiling
+ * test.cpp), TESTS_COUNT_ALLOCATIONS replaces the global operators new and delete by ones which count the allocations
+ * of each thread (see assert_no_alloc). Each block gets a header which records its size.
+*/
+#if defined(TESTS_COUNT_ALLOCATIONS) && (!defined(TESTS_SEPARATE_COMPILATION) || defined(TESTS_IMPLEMENTATION))
+namespace tests
+{
+	namespace counting
+	{
+		const std::size_t header = 16; // the size and the address of the block, before the memory given
+
+		inline void* allocate(std::size_t size, std::size_t alignment)
+		{
+			if(alignment<header) alignment = header;
+			for(;;){
+				char* block = static_cast<char*>(std::malloc(size+alignment+header));
+				if(block!=nullptr){
+					char* memory = reinterpret_cast<char*>((reinterpret_cast<std::uintptr_t>(block)+header+alignment-1) & ~(std::uintptr_t)(alignment-1));
+					reinterpret_cast<std::size_t*>(memory)[-1] = size;
+					reinterpret_cast<void**>(memory-sizeof(std::size_t))[-1] = block;
+					AllocationCounters& counters = allocation_counters();
+					counters.count++;
+					counters.bytes += size;
+					counters.live += size;
+					if(counters.live>counters.peak) counters.peak = counters.live;
+					return memory;
+				}
+				std::new_handler handler = std::get_new_handler();
+				if(handler==nullptr) return nullptr;
+				handler();
+			}
+		}
+		inline void release(void* pointer)
+		{
+			if(pointer==nullptr) return;
+			char* memory = static_cast<char*>(pointer);
+			allocation_counters().live -= reinterpret_cast<std::size_t*>(memory)[-1];
+			std::free(reinterpret_cast<void**>(memory-sizeof(std::size_t))[-1]);
+		}
+		inline void* allocate_or_throw(std::size_t size, std::size_t alignment)
+		{
+			void* memory = allocate(size, alignment);
+			if(memory==nullptr) throw std::bad_alloc();
+			return memory;
+		}
+		struct Enable
+		{
+			Enable() { allocations_counted() = true; }
+		};
+		static Enable enable;
+	}
 }
 
+void* operator new(std::size_t size) { return tests::counting::allocate_or_throw(size, 0); }
+void* operator new[](std::size_t size) { return tests::counting::allocate_or_throw(size, 0); }
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept { return tests::counting::allocate(size, 0); }
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept { return tests::counting::allocate(size, 0); }
+void operator delete(void* pointer) noexcept { tests::counting::release(pointer); }
+void operator delete[](void* pointer) noexcept { tests::counting::release(pointer); }
+void operator delete(void* pointer, const std::nothrow_t&) noexcept { tests::counting::release(pointer); }
+void operator delete[](void* pointer, const std::nothrow_t&) noexcept { tests::counting::release(pointer); }
+#if defined(__cpp_sized_deallocation)
+void operator delete(void* pointer, std::size_t) noexcept { tests::counting::release(pointer); }
+void operator delete[](void* pointer, std::size_t) noexcept { tests::counting::release(pointer); }
+#endif
+#if defined(__cpp_aligned_new)
+void* operator new(std::size_t size, std::align_val_t alignment) { return tests::counting::allocate_or_throw(size, (std::size_t)alignment); }
+void* operator new[](std::size_t size, std::align_val_t alignment) { return tests::counting::allocate_or_throw(size, (std::size_t)alignment); }
+void* operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept { return tests::counting::allocate(size, (std::size_t)alignment); }
+void* operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept { return tests::counting::allocate(size, (std::size_t)alignment); }
+void operator delete(void* pointer, std::align_val_t) noexcept { tests::counting::release(pointer); }
+void operator delete[](void* pointer, std::align_val_t) noexcept { tests::counting::release(pointer); }
+void operator delete(void* pointer, std::size_t, std::align_val_t) noexcept { tests::counting::release(pointer); }
+void operator delete[](void* pointer, std::size_t, std::align_val_t) noexcept { tests::counting::release(pointer); }
+void operator delete(void* pointer, std::align_val_t, const std::nothrow_t&) noexcept { tests::counting::release(pointer); }
+void operator delete[](void* pointer, std::align_val_t, const std::nothrow_t&) noexcept { tests::counting::release(pointer); }
+#endif
+#endif
+
+#if defined(FUZZING_BUILD_MODE_UNSAFE_FOR_PRODUCTION)
+#define TESTS_FUZZ_MAIN
+#else
+#define TESTS_FUZZ_MAIN \
+	int main(int argc, char** argv){ \
+		return tests::replay_corpus(argc, argv, LLVMFuzzerTestOneInput); \
+	}
+#endif
+
 
 #endif
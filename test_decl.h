@@ -0,0 +1,1772 @@
+#ifndef TESTDECLH
+#define TESTDECLH
+/**
+ * Declarations of the framework : the Test class and its assertions, without the heavy machinery
+ * (threads, reporters, suites, benchmarks) and without iostream.
+ * Files of huge suites include this header and are compiled with TESTS_SEPARATE_COMPILATION defined,
+ * with test.cpp which compiles the implementation once. Other programs simply include test.h.
+ * Properties (for_all), data files (for_each_csv, for_each_binary) and the membership assertions on whole collections (assert_contains_all,
+ * assert_contains_none) are defined in test.h : files which use them include test.h.
+*/
+#if !defined(TESTS_SEPARATE_COMPILATION) && !defined(TESTH)
+#error "test_decl.h needs TESTS_SEPARATE_COMPILATION and test.cpp, or include test.h"
+#endif
+#include <string>
+#include <iosfwd>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <iterator>
+#include <vector>
+#include <tuple>
+#include <atomic>
+#include <typeinfo>
+#include <new>
+#include <utility>
+
+#if defined(__GNUC__) || defined(__clang__)
+#define TESTS_NOINLINE __attribute__((noinline, cold))
+#elif defined(_MSC_VER)
+#define TESTS_NOINLINE __declspec(noinline)
+#else
+#define TESTS_NOINLINE
+#endif
+
+// RTTI may be disabled (-fno-rtti) : then tests must override name(), and types are compared at compile time
+#if defined(__GXX_RTTI) || defined(_CPPRTTI) || defined(__cpp_rtti)
+#define TESTS_RTTI
+#endif
+
+// functions declared here and defined in test.h : inline in the header-only mode, compiled once by test.cpp otherwise
+#if defined(TESTS_SEPARATE_COMPILATION)
+#define TESTS_INLINE
+#else
+#define TESTS_INLINE inline
+#endif
+
+namespace tests
+{
+	/**
+	 * Timeout value meaning "never"
+	*/
+	const unsigned long infinite = 0;
+
+	/**
+	 * Exception thrown by assertions of a test whose timeout is over
+	*/
+	class Timeout{};
+
+	/**
+	 * Name of an assertion : a view on characters, built from a C string or a std::string without copy.
+	 * It must not outlive the string it views (assertions use it only during their call).
+	*/
+	class Name
+	{
+		private:
+			const char* text;
+			std::size_t length;
+		public:
+			Name(const char* text="") : text(text), length(std::strlen(text)){}
+			Name(const std::string& text) : text(text.data()), length(text.size()){}
+			Name(const char* text, std::size_t length) : text(text), length(length){}
+			const char* data() const { return text; }
+			std::size_t size() const { return length; }
+			bool empty() const { return length==0; }
+			std::string str() const { return std::string(text, length); }
+	};
+
+	/**
+	 * Levels of details of the results of tests
+	*/
+	enum Verbosity
+	{
+		quiet, // only the resume of each test
+		failures, // failed assertions and their messages
+		all // every assertion (default)
+	};
+
+	/**
+	 * Receives the results of a test while it runs.
+	 * A reporter is used by one test at a time, from the thread which runs the test.
+	*/
+	class Reporter
+	{
+		public:
+			virtual ~Reporter(){}
+		/**
+		 * The test starts
+		 * @param test the name of the test
+		*/
+			virtual void started(Name test) = 0;
+		/**
+		 * An assertion is checked (when its level is shown)
+		 * @param name the name of the assertion
+		 * @param pass true if it passed
+		*/
+			virtual void assertion(Name name, bool pass) = 0;
+		/**
+		 * A line of details, after a failed assertion or in the resume
+		 * @param text the line (without end of line)
+		*/
+			virtual void message(Name text) = 0;
+		/**
+		 * The test ends
+		 * @param passed the number of passed assertions
+		 * @param failed the number of failed assertions
+		 * @param time the duration of the test, in milliseconds
+		*/
+			virtual void ended(int passed, int failed, double time) = 0;
+		/**
+		 * Waits until every result received is written
+		*/
+			virtual void flush(){}
+	};
+
+	class ResultCache;
+	class BaselineStore;
+	class SnapshotStore;
+	class Suite;
+
+	/**
+	 * The result of the last run of a test, in a ResultCache
+	*/
+	struct CachedResult
+	{
+		std::uint64_t key; // hash of the binary, of the name and of the input files of the test
+		int passed;
+		int failed;
+		double time; // milliseconds
+	};
+
+	/**
+	 * @returns the default output of tests : the standard output
+	*/
+	TESTS_INLINE std::ostream& default_output();
+
+	/**
+	 * @returns true if the value is a floating-point NaN
+	*/
+	template <typename T>
+	inline typename std::enable_if<std::is_floating_point<T>::value, bool>::type is_nan(const T& value)
+	{
+		return value!=value;
+	}
+	template <typename T>
+	inline typename std::enable_if<!std::is_floating_point<T>::value, bool>::type is_nan(const T&)
+	{
+		return false;
+	}
+
+	/**
+	 * Tells if two values have the same type. Their static types are compared at compile time,
+	 * unless both are polymorphic and RTTI is enabled : then their dynamic types are compared.
+	*/
+	template <typename T1, typename T2>
+	inline typename std::enable_if<!std::is_polymorphic<T1>::value || !std::is_polymorphic<T2>::value, bool>::type
+		same_type(const T1&, const T2&)
+	{
+		return std::is_same<T1,T2>::value;
+	}
+	template <typename T1, typename T2>
+	inline typename std::enable_if<std::is_polymorphic<T1>::value && std::is_polymorphic<T2>::value, bool>::type
+		same_type(const T1& value1, const T2& value2)
+	{
+#if defined(TESTS_RTTI)
+		return typeid(value1)==typeid(value2);
+#else
+		(void)value1;
+		(void)value2;
+		return std::is_same<T1,T2>::value;
+#endif
+	}
+
+	/**
+	 * Tells if a value of type T can be sent to an output stream
+	*/
+	template <typename T>
+	struct is_printable
+	{
+		private:
+			// the stream is a parameter : it is only looked at when a value is printed
+			template <typename U, typename S> static auto check(int) -> decltype(std::declval<S&>() << std::declval<const U&>(), std::true_type());
+			template <typename U, typename S> static std::false_type check(...);
+		public:
+			static const bool value = decltype(check<T, std::ostream>(0))::value;
+	};
+
+	// formatting of the values of failed assertions, compiled with the implementation
+	TESTS_INLINE void print_integer(std::ostream& output, long long value);
+	TESTS_INLINE void print_integer(std::ostream& output, unsigned long long value);
+	TESTS_INLINE void print_real(std::ostream& output, long double value);
+	TESTS_INLINE void print_text(std::ostream& output, const char* text);
+	TESTS_INLINE void print_text(std::ostream& output, const std::string& text);
+	TESTS_INLINE void print_character(std::ostream& output, char value);
+	TESTS_INLINE void print_pointer(std::ostream& output, const void* pointer);
+
+	/**
+	 * Sends a value to a stream : characters as characters, other small integers as numbers,
+	 * and "?" for values which cannot be printed
+	*/
+	template <typename T>
+	inline typename std::enable_if<(std::is_integral<T>::value && std::is_signed<T>::value) || std::is_enum<T>::value>::type
+		print_element(std::ostream& output, const T& value)
+	{
+		print_integer(output, (long long)value);
+	}
+	template <typename T>
+	inline typename std::enable_if<std::is_integral<T>::value && !std::is_signed<T>::value>::type print_element(std::ostream& output, const T& value)
+	{
+		print_integer(output, (unsigned long long)value);
+	}
+	template <typename T>
+	inline typename std::enable_if<std::is_floating_point<T>::value>::type print_element(std::ostream& output, const T& value)
+	{
+		print_real(output, value);
+	}
+	// pointers and arrays : C strings are printed as text
+	template <typename T>
+	inline typename std::enable_if<std::is_pointer<typename std::decay<T>::type>::value>::type print_element(std::ostream& output, const T& value)
+	{
+		typedef typename std::decay<T>::type pointer;
+		typedef typename std::remove_cv<typename std::remove_pointer<pointer>::type>::type pointed;
+		pointer address = value;
+		if(std::is_same<pointed,char>::value && address!=nullptr) print_text(output, (const char*)address);
+		else print_pointer(output, (const void*)address);
+	}
+	template <typename T>
+	struct is_other_value
+	{
+		static const bool value = !std::is_arithmetic<T>::value && !std::is_enum<T>::value && !std::is_pointer<typename std::decay<T>::type>::value;
+	};
+	template <typename T>
+	inline typename std::enable_if<is_other_value<T>::value && is_printable<T>::value>::type print_element(std::ostream& output, const T& value)
+	{
+		output << value;
+	}
+	template <typename T>
+	inline typename std::enable_if<is_other_value<T>::value && !is_printable<T>::value>::type print_element(std::ostream& output, const T&)
+	{
+		print_text(output, "?");
+	}
+	inline void print_element(std::ostream& output, char value) { print_character(output, value); }
+	inline void print_element(std::ostream& output, const std::string& value) { print_text(output, value); }
+
+	/**
+	 * Reference to a value whose type is erased : it is formatted by print_value<T> only when an assertion fails,
+	 * so the formatting code of common types is compiled once (see the extern templates at the end of this file).
+	*/
+	struct Value
+	{
+		const void* value;
+		void (*print)(std::ostream&, const void*);
+	};
+	template <typename T>
+	void print_value(std::ostream& output, const void* value)
+	{
+		print_element(output, *static_cast<const T*>(value));
+	}
+	template <typename T>
+	inline Value value_of(const T& value)
+	{
+		Value result = { &value, &print_value<T> };
+		return result;
+	}
+
+	/**
+	 * Elements of a collection whose type is erased, formatted one by one only when an assertion fails
+	*/
+	struct Elements
+	{
+		const void* values; // the iterator on the first element, or a vector of iterators
+		void (*print)(std::ostream&, const void*, std::size_t);
+	};
+	// prints the element at an index from an iterator
+	template <typename iterator>
+	void print_nth(std::ostream& output, const void* first, std::size_t index)
+	{
+		iterator element = *static_cast<const iterator*>(first);
+		std::advance(element, index);
+		print_element(output, *element);
+	}
+	// copies of the last elements read from a collection read in one pass, kept to be shown on failure
+	template <typename T>
+	struct KeptElements
+	{
+		std::vector<T> values; // a ring of the last elements
+		std::size_t capacity;
+		explicit KeptElements(std::size_t capacity) : capacity(capacity){}
+		void keep(std::size_t index, const T& value){
+			if(values.size()<capacity) values.push_back(value);
+			else values[index%capacity] = value;
+		}
+		const T& at(std::size_t index) const { return values[values.size()<capacity ? index : index%capacity]; }
+	};
+	// prints a kept element at an index
+	template <typename T>
+	void print_kept(std::ostream& output, const void* kept, std::size_t index)
+	{
+		print_element(output, static_cast<const KeptElements<T>*>(kept)->at(index));
+	}
+	// prints the element of the iterator at an index of a vector of iterators
+	template <typename iterator>
+	void print_pointed(std::ostream& output, const void* iterators, std::size_t index)
+	{
+		print_element(output, *(*static_cast<const std::vector<iterator>*>(iterators))[index]);
+	}
+
+	/**
+	 * Tells if an iterator walks through contiguous memory : pointers, and iterators of std::vector
+	 * (but std::vector<bool>) and std::basic_string
+	*/
+	template <typename iterator>
+	struct is_contiguous_iterator
+	{
+		private:
+			typedef typename std::remove_cv<typename std::iterator_traits<iterator>::value_type>::type value_type;
+			template <typename V> struct in_vector
+			{
+				static const bool value = std::is_same<iterator, typename std::vector<V>::iterator>::value
+					|| std::is_same<iterator, typename std::vector<V>::const_iterator>::value;
+			};
+			template <typename V, bool character> struct in_string { static const bool value = false; };
+			template <typename V> struct in_string<V,true>
+			{
+				static const bool value = std::is_same<iterator, typename std::basic_string<V>::iterator>::value
+					|| std::is_same<iterator, typename std::basic_string<V>::const_iterator>::value;
+			};
+			template <typename V> struct is_character
+			{
+				static const bool value = std::is_same<V,char>::value || std::is_same<V,wchar_t>::value
+					|| std::is_same<V,char16_t>::value || std::is_same<V,char32_t>::value;
+			};
+		public:
+			static const bool value = std::is_pointer<iterator>::value
+				|| (!std::is_same<value_type,bool>::value && in_vector<value_type>::value)
+				|| in_string<value_type, is_character<value_type>::value>::value;
+	};
+
+	/**
+	 * Tells if two values of type T are equal exactly when their bytes are equal
+	 * (integers, characters, enumerations and pointers ; not floating-point numbers, whose 0.0 and -0.0 are equal)
+	*/
+	template <typename T>
+	struct is_bytewise_comparable
+	{
+		static const bool value = std::is_integral<T>::value || std::is_enum<T>::value || std::is_pointer<T>::value;
+	};
+
+	/**
+	 * Finds the first different byte of two buffers, with AVX2 or SSE2 instructions when the processor has them
+	 * @param first the first buffer
+	 * @param second the second buffer
+	 * @param size the size of the buffers, in bytes
+	 * @returns the index of the first different byte, or size if the buffers are equal
+	*/
+	TESTS_INLINE std::size_t first_mismatch(const void* first, const void* second, std::size_t size);
+
+	/**
+	 * Tells if C is a container : it has begin() and end()
+	*/
+	template <typename C>
+	struct is_container
+	{
+		private:
+			template <typename U> static auto check(int) -> decltype(std::declval<const U&>().begin()==std::declval<const U&>().end(), std::true_type());
+			template <typename U> static std::false_type check(...);
+		public:
+			static const bool value = decltype(check<C>(0))::value;
+	};
+
+	/**
+	 * Tells if a container has its own find(value) function (sets, maps, unordered sets...)
+	*/
+	template <typename C, typename T>
+	struct has_find
+	{
+		private:
+			template <typename U> static auto check(int) -> decltype(std::declval<const U&>().find(std::declval<const T&>())==std::declval<const U&>().end(), std::true_type());
+			template <typename U> static std::false_type check(...);
+		public:
+			static const bool value = decltype(check<C>(0))::value;
+	};
+
+	/**
+	 * Tag of the membership assertions on sorted ranges, which use a binary search
+	*/
+	struct SortedRange{};
+	const SortedRange sorted_range = SortedRange();
+
+	/**
+	 * Looks for a value in a range
+	 * @returns the iterator on the first element equal to the value, or last
+	*/
+	template <typename iterator, typename T>
+	inline iterator find_value(iterator first, iterator last, const T& value)
+	{
+		for(;first!=last;++first)
+			if(*first==value) break;
+		return first;
+	}
+
+	/**
+	 * Looks for a value in a sorted range, with a binary search
+	 * @returns true if the range contains the value
+	*/
+	template <typename iterator, typename T>
+	inline bool sorted_contains(iterator first, iterator last, const T& value)
+	{
+		typename std::iterator_traits<iterator>::difference_type count = std::distance(first, last);
+		while(count>0){
+			typename std::iterator_traits<iterator>::difference_type half = count/2;
+			iterator middle = first;
+			std::advance(middle, half);
+			if(*middle < value){
+				first = ++middle;
+				count -= half+1;
+			}
+			else count = half;
+		}
+		return first!=last && !(value < *first);
+	}
+
+	/**
+	 * Looks for a value in a container, with its own find function when it has one
+	 * @returns true if the container contains the value
+	*/
+	template <typename C, typename T>
+	inline typename std::enable_if<has_find<C,T>::value, bool>::type contains(const C& values, const T& value)
+	{
+		return values.find(value)!=values.end();
+	}
+	template <typename C, typename T>
+	inline typename std::enable_if<!has_find<C,T>::value, bool>::type contains(const C& values, const T& value)
+	{
+		return find_value(values.begin(), values.end(), value)!=values.end();
+	}
+
+	/**
+	 * Complexity classes, for assert_complexity : O(1), O(log n), O(n), O(n log n), O(n^2), O(n^3)
+	*/
+	enum Complexity
+	{
+		O_1,
+		O_log_n,
+		O_n,
+		O_n_log_n,
+		O_n2,
+		O_n3
+	};
+
+	/**
+	 * Forces the compiler to compute a value, even if it is never used
+	 * @param value the value
+	 * @tparam T the type of the value
+	*/
+	template <typename T>
+	inline void do_not_optimize(const T& value)
+	{
+#if defined(__GNUC__) || defined(__clang__)
+		asm volatile("" : : "r,m"(value) : "memory");
+#else
+		const volatile char* sink = reinterpret_cast<const volatile char*>(&value);
+		(void)*sink;
+		std::atomic_signal_fence(std::memory_order_seq_cst);
+#endif
+	}
+
+	/**
+	 * Forces the compiler to perform all pending writes to memory
+	*/
+	inline void clobber_memory()
+	{
+#if defined(__GNUC__) || defined(__clang__)
+		asm volatile("" : : : "memory");
+#else
+		std::atomic_signal_fence(std::memory_order_seq_cst);
+#endif
+	}
+
+	/**
+	 * Heap allocations of a thread, counted when the program defines TESTS_COUNT_ALLOCATIONS (see test.h)
+	*/
+	struct AllocationCounters
+	{
+		std::uint64_t count; // allocations
+		std::uint64_t bytes; // allocated bytes
+		std::int64_t live; // allocated bytes not freed yet (memory freed by other threads is not counted)
+		std::int64_t peak; // maximum of live
+	};
+	/**
+	 * @returns the counters of the allocations of the calling thread
+	*/
+	TESTS_INLINE AllocationCounters& allocation_counters();
+	/**
+	 * @returns true when allocations are counted : set by the operators new of TESTS_COUNT_ALLOCATIONS
+	*/
+	TESTS_INLINE bool& allocations_counted();
+
+	/**
+	 * A point where the threads of Test::stress may be perturbed : with the probability set by
+	 * Test::set_stress_perturbation, the calling thread yields or spins a little, as drawn from the seed of the stress.
+	 * It does nothing out of a stress.
+	*/
+	TESTS_INLINE void stress_point();
+
+	/**
+	 * Monotonic allocator : objects are allocated by moving a pointer in big blocks, and are all released
+	 * at once by reset(), which keeps the blocks for the next uses. Reset costs O(1) when the objects
+	 * are trivially destructible, else their destructors are called (in reverse order of creation).
+	 * An arena is not thread safe.
+	*/
+	class Arena
+	{
+		private:
+			struct Block
+			{
+				Block* next;
+				std::size_t size; // bytes of data, after the block header
+			};
+			struct Cleanup
+			{
+				Cleanup* next;
+				void (*destroy)(void*);
+				void* object;
+			};
+			Block* first;
+			Block* current;
+			char* position;
+			char* end;
+			Cleanup* cleanups;
+			std::size_t block_size;
+			static char* data(Block* block) { return reinterpret_cast<char*>(block+1); }
+			// moves to the next block, or inserts a new one big enough
+			TESTS_INLINE void* grow(std::size_t size, std::size_t alignment);
+			template <typename T>
+			static void destroy(void* object) { static_cast<T*>(object)->~T(); }
+			template <typename T>
+			void cleanup(T*, std::true_type){}
+			template <typename T>
+			void cleanup(T* object, std::false_type){
+				Cleanup* entry = new(allocate(sizeof(Cleanup), alignof(Cleanup))) Cleanup();
+				entry->next = cleanups;
+				entry->destroy = &destroy<T>;
+				entry->object = object;
+				cleanups = entry;
+			}
+		public:
+		/**
+		 * @param block_size the size of the first block, in bytes (the next ones are twice bigger)
+		*/
+			explicit Arena(std::size_t block_size=65536)
+				: first(nullptr), current(nullptr), position(nullptr), end(nullptr), cleanups(nullptr), block_size(block_size){}
+			TESTS_INLINE ~Arena();
+			Arena(const Arena&) = delete;
+			Arena& operator=(const Arena&) = delete;
+		/**
+		 * Allocates memory, released by reset()
+		 * @param size the size, in bytes
+		 * @param alignment the alignment, a power of 2
+		*/
+			void* allocate(std::size_t size, std::size_t alignment=alignof(std::max_align_t)){
+				std::uintptr_t address = (reinterpret_cast<std::uintptr_t>(position)+alignment-1) & ~(std::uintptr_t)(alignment-1);
+				if(position==nullptr || size>(std::size_t)(reinterpret_cast<std::uintptr_t>(end)-address) || address>reinterpret_cast<std::uintptr_t>(end))
+					return grow(size, alignment);
+				position = reinterpret_cast<char*>(address+size);
+				return reinterpret_cast<void*>(address);
+			}
+		/**
+		 * Creates an object in the arena : it is destroyed by reset()
+		 * @param args the arguments of its constructor
+		 * @tparam T the type of the object
+		*/
+			template <typename T, typename... Args>
+			T* make(Args&&... args){
+				T* object = new(allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+				cleanup(object, std::integral_constant<bool, std::is_trivially_destructible<T>::value>());
+				return object;
+			}
+		/**
+		 * Destroys the objects and releases the memory of the arena at once. The blocks are kept.
+		*/
+			void reset(){
+				for(;cleanups!=nullptr;cleanups=cleanups->next) cleanups->destroy(cleanups->object);
+				current = first;
+				position = first!=nullptr ? data(first) : nullptr;
+				end = first!=nullptr ? position+first->size : nullptr;
+			}
+		/**
+		 * @returns the size of the blocks of the arena, in bytes
+		*/
+			TESTS_INLINE std::size_t capacity() const;
+	};
+
+	/**
+	 * Allocator of the standard containers which allocates in an arena : std::vector<int, ArenaAllocator<int>> values(arena)
+	 * Memory is only released by the reset of the arena.
+	*/
+	template <typename T>
+	class ArenaAllocator
+	{
+		private:
+			template <typename U> friend class ArenaAllocator;
+			Arena* arena;
+		public:
+			typedef T value_type;
+			ArenaAllocator(Arena& arena) : arena(&arena){}
+			template <typename U>
+			ArenaAllocator(const ArenaAllocator<U>& other) : arena(other.arena){}
+			T* allocate(std::size_t count) { return static_cast<T*>(arena->allocate(count*sizeof(T), alignof(T))); }
+			void deallocate(T*, std::size_t){}
+			template <typename U>
+			bool operator==(const ArenaAllocator<U>& other) const { return arena==other.arena; }
+			template <typename U>
+			bool operator!=(const ArenaAllocator<U>& other) const { return arena!=other.arena; }
+	};
+
+	/**
+	 * Fixture shared by the tests which declare it (see Test::uses) : its value is built once, lazily and
+	 * thread-safely, by the first test which needs it or by the suite before it runs its tests, then it is only read.
+	 * When building the value throws, the tests which need it fail, and the next one tries again.
+	*/
+	class Fixture
+	{
+		private:
+			std::atomic<void*> value;
+			std::atomic<bool> building;
+			TESTS_INLINE void* build();
+		protected:
+			virtual void* create() = 0;
+			void* get(){
+				void* built = value.load(std::memory_order_acquire);
+				return built!=nullptr ? built : build();
+			}
+			void* existing() const { return value.load(std::memory_order_acquire); }
+		public:
+			Fixture() : value(nullptr), building(false){}
+			virtual ~Fixture(){}
+			Fixture(const Fixture&) = delete;
+			Fixture& operator=(const Fixture&) = delete;
+		/**
+		 * Builds the value if it is not built yet
+		*/
+			void prepare() { get(); }
+		/**
+		 * @returns true if the value is built
+		*/
+			bool ready() const { return existing()!=nullptr; }
+	};
+
+	/**
+	 * Shared fixture of type T, built by a factory (default : new T()) :
+	 * static tests::SharedFixture<Index> index([]{ return new Index("data.csv"); });
+	 * Tests declare it with uses(index), then read it with *index or index->...
+	 * @tparam T the type of the value
+	*/
+	template <typename T>
+	class SharedFixture : public Fixture
+	{
+		private:
+			T* (*factory)();
+			static T* make() { return new T(); }
+			void* create() override { return factory(); }
+		public:
+		/**
+		 * @param factory the function which builds the value (a lambda without capture)
+		*/
+			explicit SharedFixture(T* (*factory)()=&make) : factory(factory){}
+			~SharedFixture() { delete static_cast<T*>(existing()); }
+			const T& operator*() { return *static_cast<const T*>(get()); }
+			const T* operator->() { return static_cast<const T*>(get()); }
+	};
+
+	// compile-time sequence of indexes 0..N-1, to expand tuples into arguments
+	template <std::size_t... I> struct Indexes{};
+	template <std::size_t N, std::size_t... I> struct MakeIndexes : MakeIndexes<N-1, N-1, I...>{};
+	template <std::size_t... I> struct MakeIndexes<0, I...> { typedef Indexes<I...> type; };
+
+	/**
+	 * Very simple class to make units tests in C++
+	 * To create a test case, you must inherit this class and overrides test_code
+	 * This class contains a lot of assert_xx methods to make tests
+	 * It computes the times taken for tests
+	 * All outputs are sent to an standard output stream (who may be std::cout but not only)
+	 * @author alexandre guidet
+	 * @version 1
+	 * @see https://github.com/AlexandreGuidet/SimpliestCPPUnitTests
+	*/
+	class Test
+	{
+		private:
+			struct Internals; // the reporter of assertions called outside of run(), the chronometer, the watch dog, the timings
+			int failed;
+			int passed;
+			int static_passed; // tests checked at compile time, among the passed ones
+			std::ostream* output;
+			Reporter* reporter; // chosen by the user, or nullptr
+			Internals* internals;
+			Reporter* current; // reporter of the running test
+			Verbosity verbosity;
+			unsigned long timeout_delay;
+			bool timing;
+			unsigned long long mark; // end of the previous assertion, in ticks
+			std::atomic<bool> timed_out;
+			std::uint64_t property_cases;
+			std::uint64_t property_seed; // 0 : a new seed for each property
+			unsigned property_threads; // 0 : the number of cores
+			unsigned data_threads; // threads of the data-driven tests, 0 : the number of cores
+			bool cores_shared; // run by a suite beside other tests : its pools have one thread by default
+			bool fuzzing; // failed assertions abort the process
+			bool fuzz_failed;
+			ResultCache* cache; // nullptr : the test always runs
+			std::vector<std::string> inputs; // files whose content changes the result of the test
+			std::size_t complexity_first; // sizes of the inputs of assert_complexity
+			std::size_t complexity_last;
+			unsigned stress_rounds; // rounds of each number of threads of stress
+			bool stress_pinned; // each thread of stress runs on its own core
+			std::uint64_t stress_seed; // 0 : a new seed for each stress
+			double stress_perturbation; // probability of a perturbation at each stress_point
+			BaselineStore* baseline; // nullptr : the time assertions have no baseline
+			bool perf_counters; // reads the performance counters around test_code
+			SnapshotStore* snapshots; // nullptr : the snapshot assertions fail
+			std::vector<Fixture*> fixtures; // shared fixtures declared by the test
+			Arena* memory; // arena of the running test
+			unsigned rank; // rank of the test among the tests of its suite which have the same name
+			friend class Suite;
+			friend class AsyncTest;
+		public:
+		/**
+		 * Default timeout of tests, in milliseconds
+		*/
+			static const unsigned long default_timeout = 30000;
+		/**
+		 * Initialize the test.
+		 * @param output the stream to output the tests (default : the standard output)
+		 * @param timeout the maximum duration of the test in milliseconds (default : 30s, may be tests::infinite).
+		 * When it is over, the next assertion stops the test, which fails.
+		*/
+			TESTS_INLINE Test(std::ostream& output=default_output(), unsigned long timeout=default_timeout);
+			TESTS_INLINE virtual ~Test();
+			Test(const Test&) = delete;
+			Test& operator=(const Test&) = delete;
+		/**
+		 * Runs the test and outputs the results on the stream
+		*/
+			TESTS_INLINE void run();
+		/**
+		 * Sets the reporter which receives the results of the test.
+		 * By default, an AsyncReporter writes them to the output stream, from a background thread : a StreamReporter
+		 * keeps them in order with what the test code itself writes to the stream.
+		 * @param reporter the reporter (must live while the test runs), or nullptr for the default one
+		*/
+			void set_reporter(Reporter* reporter) { this->reporter = reporter; }
+		/**
+		 * Sets the level of details of the results (default : all, every assertion is shown)
+		 * @param level the level : all, failures (passed assertions are not shown) or quiet (only the resume)
+		*/
+			void set_verbosity(Verbosity level) { verbosity = level; }
+		/**
+		 * @returns the timeout of the test, in milliseconds
+		*/
+			unsigned long timeout() const { return timeout_delay; }
+		/**
+		 * Enables or disables the timing of assertions : for each assertion name, the count, total and maximum
+		 * of the time spent since the end of the previous assertion (the code which computes the tested values,
+		 * and the assertion itself) are shown in the resume.
+		 * @param enabled true to time assertions
+		*/
+			void set_assertion_timing(bool enabled) { timing = enabled; }
+		/**
+		 * Sets the number of cases checked by each property (see for_all, default : 10000)
+		*/
+			void set_property_cases(std::uint64_t cases) { property_cases = cases; }
+		/**
+		 * Sets the seed of the properties, to replay a failure (default : 0, a new seed for each property).
+		 * The seed of a failed property is shown with the counterexample.
+		*/
+			void set_property_seed(std::uint64_t seed) { property_seed = seed; }
+		/**
+		 * Sets the number of threads which check the properties (default : 0, the number of cores, or 1 when
+		 * the test runs in a suite beside other tests). Properties must be thread safe when it is not 1.
+		*/
+			void set_property_threads(unsigned threads) { property_threads = threads; }
+		/**
+		 * Sets the number of threads which check the records of the data files (default : 0, the number of cores,
+		 * or 1 when the test runs in a suite beside other tests). The hooks of for_each_csv and for_each_binary
+		 * must be thread safe when it is not 1.
+		*/
+			void set_data_threads(unsigned threads) { data_threads = threads; }
+		/**
+		 * Sets the sizes of the inputs of assert_complexity : a geometric series of ratio 2 from first to last
+		 * (default : 1024 to 2^20, smaller inputs mostly measure constant costs). It stops earlier when a call lasts more than 50 ms.
+		*/
+			void set_complexity_sizes(std::size_t first, std::size_t last) { complexity_first = first; complexity_last = last; }
+		/**
+		 * Sets the number of rounds of stress for each number of threads : the invariant is checked after each round (default : 10)
+		*/
+			void set_stress_rounds(unsigned rounds) { stress_rounds = rounds; }
+		/**
+		 * Pins each thread of stress to its own core (Linux only, default : false)
+		*/
+			void set_stress_pinning(bool pinned) { stress_pinned = pinned; }
+		/**
+		 * Sets the seed of the perturbations of stress, to replay them (default : 0, a new seed for each stress)
+		*/
+			void set_stress_seed(std::uint64_t seed) { stress_seed = seed; }
+		/**
+		 * Sets the probability that a thread of stress is perturbed at each call of tests::stress_point (default : 0.05)
+		*/
+			void set_stress_perturbation(double probability) { stress_perturbation = probability; }
+		/**
+		 * Sets the cache of the results of the test : when the test passed with the same program and the same
+		 * input files (see add_input), it is not run again and its result is read from the cache.
+		 * @param cache the cache (must live while the test runs), or nullptr to always run the test
+		*/
+			void set_cache(ResultCache* cache) { this->cache = cache; }
+		/**
+		 * Declares a file read by the test : a change of its content makes the test run again (see set_cache)
+		 * @param path the path of the file
+		*/
+			void add_input(const std::string& path) { inputs.push_back(path); }
+		/**
+		 * Sets the store of the baselines of the time assertions (see assert_faster_than) : their samples are
+		 * recorded, or compared to the baseline, and an assertion significantly slower than its baseline fails.
+		 * @param store the store (must live while the test runs), or nullptr
+		*/
+			void set_baseline(BaselineStore* store) { baseline = store; }
+		/**
+		 * Reads the performance counters of the thread around test_code (see PerfCounters) : the resume of the
+		 * test shows the instructions per cycle, the cycles, the misses and the faults of the test.
+		*/
+			void set_perf_counters(bool enabled) { perf_counters = enabled; }
+		/**
+		 * Sets the store of the snapshots of the outputs (see assert_snapshot)
+		 * @param store the store (must live while the test runs), or nullptr
+		*/
+			void set_snapshots(SnapshotStore* store) { snapshots = store; }
+		/**
+		 * @returns the number of assertions passed during the last run
+		*/
+			int passed_count() const { return passed; }
+		/**
+		 * @returns the number of assertions failed during the last run
+		*/
+			int failed_count() const { return failed; }
+		/**
+		 * @returns the duration of the last run, in milliseconds
+		*/
+			TESTS_INLINE double time();
+		/**
+		 * Name of the test, used by suites in their reports.
+		 * Override it to give a readable name (default : the name of the dynamic type, "test" without RTTI)
+		*/
+			TESTS_INLINE virtual std::string name() const;
+		/**
+		 * Runs fuzz_code on an input, as a fuzzing oracle (see TESTS_FUZZ_TARGET) :
+		 * passed assertions are only counted, a failed one is written on the standard error,
+		 * then the process aborts (at the next assertion or at the end of the input) so the fuzzer records a crash.
+		 * @param data the input
+		 * @param size the size of the input, in bytes
+		*/
+			TESTS_INLINE void fuzz(const std::uint8_t* data, std::size_t size);
+
+		private:
+			// guarded : the timeout is enforced by the watch dog (not in isolated workers, whose parent kills them)
+			TESTS_INLINE void execute(bool guarded);
+			// the steps of execute : start_execute returns false if the result is read from the cache, else it starts
+			// the measures of the code (with the arena of the test, nullptr : the arena of the thread), finish_execute
+			// stops them, and end_execute writes the resume
+			TESTS_INLINE bool start_execute(bool guarded, Arena* arena);
+			TESTS_INLINE void finish_execute(bool guarded);
+			TESTS_INLINE void end_execute();
+			// the name of the test in the files of results (caches, timings, snapshots, baselines) : its name,
+			// followed by its rank when other tests of its suite have the same name
+			TESTS_INLINE std::string stored_name() const;
+			// the key of the results of the test in a cache : its name, the program and its input files
+			TESTS_INLINE std::uint64_t cache_key() const;
+			// finds the result of the last run if it passed with the same program and inputs
+			TESTS_INLINE bool cached_result(CachedResult& result) const;
+			// true if the test failed during its last run
+			TESTS_INLINE bool failed_before() const;
+			// records a result, unless it comes from the cache
+			TESTS_INLINE void to_cache(int passed, int failed, double time);
+			TESTS_INLINE void print_header();
+			TESTS_INLINE void print_resume();
+			TESTS_INLINE void print_timings();
+			TESTS_INLINE void time_assertion(Name name);
+			TESTS_INLINE void mark_assertion();
+			void print_result(Name name, bool pass){
+				// timed and fuzzed assertions take the slow path : a passed assertion only tests two flags
+				if(timing || fuzzing){
+					print_special_result(name, pass);
+					return;
+				}
+				if(verbosity==all || (!pass && verbosity==failures))
+					current->assertion(name,pass);
+				check_timeout();
+			}
+			TESTS_NOINLINE TESTS_INLINE void print_special_result(Name name, bool pass);
+			void print_message(Name text){
+				if(verbosity!=quiet) current->message(text);
+			}
+			TESTS_NOINLINE TESTS_INLINE void fuzz_abort();
+			// contiguous collections of bytewise comparable elements : memcmp, then vector instructions to locate the difference
+			template <typename iter1, typename iter2>
+			void compare_collections(iter1 first1, iter1 last1, iter2 first2, iter2 last2, Name name, std::true_type)
+			{
+				typedef typename std::remove_cv<typename std::iterator_traits<iter1>::value_type>::type value_type;
+				std::size_t size1 = last1-first1, size2 = last2-first2;
+				std::size_t common = size1<size2 ? size1 : size2;
+				const value_type* a = size1>0 ? &*first1 : nullptr;
+				const value_type* b = size2>0 ? &*first2 : nullptr;
+				if(size1==size2 && (common==0 || std::memcmp(a, b, common*sizeof(value_type))==0)){
+					passes(name);
+					return;
+				}
+				std::size_t index = common==0 ? 0 : first_mismatch(a, b, common*sizeof(value_type))/sizeof(value_type);
+				std::size_t differences = 0;
+				for(std::size_t i=index;i<common;i++) differences += a[i]!=b[i] ? 1 : 0;
+				Elements first = { &a, &print_nth<const value_type*> }, second = { &b, &print_nth<const value_type*> };
+				collections_differ(name, first, size1, second, size2, index, differences);
+			}
+			// other collections : element by element, in one pass if one of them is read by an input iterator
+			template <typename iter1, typename iter2>
+			void compare_collections(iter1 first1, iter1 last1, iter2 first2, iter2 last2, Name name, std::false_type)
+			{
+				typedef typename std::iterator_traits<iter1>::iterator_category category1;
+				typedef typename std::iterator_traits<iter2>::iterator_category category2;
+				compare_elements(first1, last1, first2, last2, name, typename std::conditional<
+					std::is_base_of<std::forward_iterator_tag, category1>::value && std::is_base_of<std::forward_iterator_tag, category2>::value,
+					std::forward_iterator_tag, std::input_iterator_tag>::type());
+			}
+			// the elements shown on failure are read again from the first ones
+			template <typename iter1, typename iter2>
+			void compare_elements(iter1 first1, iter1 last1, iter2 first2, iter2 last2, Name name, std::forward_iterator_tag)
+			{
+				iter1 i1 = first1;
+				iter2 i2 = first2;
+				std::size_t index=0, differences=0, first=0;
+				for(;i1!=last1 && i2!=last2;++i1,++i2,++index){
+					if(*i1 != *i2){
+						if(differences==0) first=index;
+						differences++;
+					}
+				}
+				if(differences==0 && i1==last1 && i2==last2){
+					passes(name);
+					return;
+				}
+				if(differences==0) first=index;
+				std::size_t size1 = index+std::distance(i1,last1), size2 = index+std::distance(i2,last2);
+				Elements elements1 = { &first1, &print_nth<iter1> }, elements2 = { &first2, &print_nth<iter2> };
+				collections_differ(name, elements1, size1, elements2, size2, first, differences);
+			}
+			// the elements shown on failure are copied while they are compared, up to the end of the window
+			template <typename iter1, typename iter2>
+			void compare_elements(iter1 first1, iter1 last1, iter2 first2, iter2 last2, Name name, std::input_iterator_tag)
+			{
+				typedef typename std::remove_cv<typename std::iterator_traits<iter1>::value_type>::type value1;
+				typedef typename std::remove_cv<typename std::iterator_traits<iter2>::value_type>::type value2;
+				KeptElements<value1> kept1(2*window+1);
+				KeptElements<value2> kept2(2*window+1);
+				std::size_t index=0, differences=0, first=0;
+				for(;first1!=last1 && first2!=last2;++first1,++first2,++index){
+					bool differ = *first1 != *first2;
+					if(differ && differences==0) first=index;
+					if(differences==0 || index<=first+window){
+						kept1.keep(index, *first1);
+						kept2.keep(index, *first2);
+					}
+					if(differ) differences++;
+				}
+				if(differences==0 && first1==last1 && first2==last2){
+					passes(name);
+					return;
+				}
+				if(differences==0) first=index;
+				std::size_t size1=index, size2=index;
+				for(;first1!=last1;++first1,++size1)
+					if(size1<=first+window) kept1.keep(size1, *first1);
+				for(;first2!=last2;++first2,++size2)
+					if(size2<=first+window) kept2.keep(size2, *first2);
+				Elements elements1 = { &kept1, &print_kept<value1> }, elements2 = { &kept2, &print_kept<value2> };
+				collections_differ(name, elements1, size1, elements2, size2, first, differences);
+			}
+			static const std::size_t window = 4; // elements shown before and after the first difference of collections
+			TESTS_NOINLINE TESTS_INLINE void collections_differ(Name name, Elements first, std::size_t size1, Elements second, std::size_t size2,
+				std::size_t index, std::size_t differences);
+			TESTS_INLINE void print_window(const char* title, Elements elements, std::size_t size, std::size_t from, std::size_t to);
+			// checks the values of [first, last) are all in the index (present) or all out of it
+			template <typename index_type, typename iterator>
+			void check_membership(const index_type& index, iterator first, iterator last, bool present, Name name)
+			{
+				std::vector<iterator> wrong;
+				for(iterator value=first;value!=last;++value)
+					if(index.contains(*value)!=present) wrong.push_back(value);
+				if(wrong.empty()) passes(name);
+				else{
+					Elements elements = { &wrong, &print_pointed<iterator> };
+					membership_failed(name, elements, wrong.size(), present);
+				}
+			}
+			template <typename container1, typename container2>
+			void check_membership(const container1& values, const container2& checked, bool present, Name name, std::true_type)
+			{
+				struct Native
+				{
+					const container1& values;
+					bool contains(const typename container2::value_type& value) const { return values.find(value)!=values.end(); }
+				};
+				Native index = { values };
+				check_membership(index, checked.begin(), checked.end(), present, name);
+			}
+			// with an index of the values (defined in test.h)
+			template <typename container1, typename container2>
+			void check_membership(const container1& values, const container2& checked, bool present, Name name, std::false_type);
+			TESTS_NOINLINE TESTS_INLINE void membership_failed(Name name, Elements wrong, std::size_t count, bool present);
+			// peak : measured is the peak of memory, else the number of allocations of bytes
+			TESTS_NOINLINE TESTS_INLINE void memory_failed(Name name, std::uint64_t measured, std::uint64_t bytes, std::uint64_t limit, bool peak);
+			// code measured by assert_faster_than
+			struct Timed
+			{
+				void* code;
+				void (*run)(void* code, std::size_t iterations);
+			};
+			template <typename function>
+			static void run_calls(void* code, std::size_t iterations){
+				function& f = *static_cast<function*>(code);
+				for(std::size_t i=0;i<iterations;i++) f();
+			}
+			TESTS_INLINE void check_time(double budget, Timed timed, Name name);
+			// code measured by assert_complexity : inputs are prepared, then the code runs on each of them
+			struct Scaled
+			{
+				void* context;
+				void* (*prepare)(void* context, std::size_t size, std::size_t count);
+				void (*run)(void* context, void* inputs);
+				void (*release)(void* inputs);
+			};
+			template <typename generator, typename function>
+			struct ScaledCode
+			{
+				typedef typename std::decay<decltype(std::declval<generator&>()(std::size_t()))>::type input;
+				generator& make;
+				function& code;
+				static void* prepare(void* context, std::size_t size, std::size_t count){
+					ScaledCode& self = *static_cast<ScaledCode*>(context);
+					std::vector<input>* inputs = new std::vector<input>();
+					inputs->reserve(count);
+					for(std::size_t i=0;i<count;i++) inputs->push_back(self.make(size));
+					return inputs;
+				}
+				static void run(void* context, void* inputs){
+					ScaledCode& self = *static_cast<ScaledCode*>(context);
+					std::vector<input>& all = *static_cast<std::vector<input>*>(inputs);
+					for(std::size_t i=0;i<all.size();i++) self.code(all[i]);
+				}
+				static void release(void* inputs) { delete static_cast<std::vector<input>*>(inputs); }
+			};
+			TESTS_INLINE void check_complexity(Complexity expected, Scaled scaled, Name name);
+			// properties (defined in test.h) : the cases are numbered, and the arguments of each one are drawn from the seed and its number
+			static std::uint64_t case_seed(std::uint64_t seed, std::uint64_t index);
+			template <typename T>
+			static void lower(std::atomic<T>& value, T candidate);
+			template <typename generators, typename values, std::size_t... I>
+			static void generate(const generators& with, std::uint64_t seed, values& into, Indexes<I...>);
+			template <typename property, typename values, std::size_t... I>
+			static bool holds(const property& p, const values& arguments, Indexes<I...>);
+			template <std::size_t K, typename generators, typename values>
+			static void shrink_argument(const generators& with, const values& current, std::vector<values>& candidates);
+			template <typename generators, typename values, std::size_t... I>
+			static void shrink_arguments(const generators& with, const values& current, std::vector<values>& candidates, Indexes<I...>);
+			template <typename T>
+			static void print_argument(std::ostream& text, const T& value);
+			static void print_argument(std::ostream& text, const std::string& value);
+			template <typename T>
+			static void print_argument(std::ostream& text, const std::vector<T>& value);
+			template <typename values, std::size_t... I>
+			static void print_arguments(std::ostream& text, const values& arguments, Indexes<I...>);
+			template <typename property, typename... G>
+			void check_property(const std::tuple<G...>& with, const property& p, Name name);
+			// code run by stress on each thread, and the invariant checked after each round
+			struct Stressed
+			{
+				void* code;
+				void (*run)(void* code, unsigned thread, std::uint64_t iteration);
+				void* invariant; // nullptr : no invariant
+				bool (*holds)(void* invariant);
+			};
+			template <typename function>
+			static void run_stressed(void* code, unsigned thread, std::uint64_t iteration){
+				(*static_cast<function*>(code))(thread, iteration);
+			}
+			template <typename invariant>
+			static bool invariant_holds(void* check){
+				return (*static_cast<invariant*>(check))();
+			}
+			TESTS_INLINE void check_stress(unsigned threads, std::uint64_t iterations, Stressed stressed, Name name);
+			// outputs of assert_snapshot, written by a producer to a stream
+			template <typename function>
+			static void produce_output(void* producer, std::ostream& output){
+				(*static_cast<function*>(producer))(output);
+			}
+			TESTS_INLINE void check_snapshot(Name name, void* producer, void (*produce)(void*, std::ostream&));
+			// data-driven tests (defined in test.h) : the mapped file is split in chunks checked on several threads
+			template <typename hook, typename... fields>
+			void check_csv(const std::string& path, const hook& h, Name name, bool header);
+			template <typename hook, typename... fields>
+			void check_binary(const std::string& path, const hook& h, Name name);
+			TESTS_NOINLINE TESTS_INLINE void record_failed(Name name, const std::string& message, const std::string& record);
+			template <typename property, typename... G>
+			TESTS_NOINLINE void property_failed(const std::tuple<G...>& with, const property& p, Name name, std::uint64_t seed, std::uint64_t index);
+		protected:
+		/**
+		 * Contains the code of the test
+		*/
+			virtual void test_code() = 0;
+		/**
+		 * Prepares the state of the test, before test_code. An exception fails the test, which does not run.
+		*/
+			virtual void set_up(){}
+		/**
+		 * Releases the state of the test, after test_code (even when it fails)
+		*/
+			virtual void tear_down(){}
+		/**
+		 * Declares a shared fixture used by the test : a suite builds it before its tests run
+		 * @param fixture the fixture (must live while the test runs)
+		*/
+			void uses(Fixture& fixture) { fixtures.push_back(&fixture); }
+		/**
+		 * Arena of the running test, for its per-test fixtures : it is reset in O(1) when the test ends,
+		 * and its memory is reused by the next tests run on the same thread.
+		*/
+			TESTS_INLINE Arena& arena();
+		/**
+		 * Contains the code of the test run on each input of a fuzzer (see fuzz), which checks it with assertions
+		 * @param data the input
+		 * @param size the size of the input, in bytes
+		*/
+			virtual void fuzz_code(const std::uint8_t* data, std::size_t size) { (void)data; (void)size; }
+		/**
+		 * Stops the test if its timeout is over. Assertions already do it :
+		 * call it from long loops without assertions.
+		 * @throws Timeout if the timeout is over
+		*/
+			void check_timeout(){
+				if(timed_out) throw Timeout();
+			}
+			// the threads of a pool of the test, from its setting (0 : the default)
+			unsigned pool_threads(unsigned threads) const {
+				return threads==0 && cores_shared ? 1 : threads;
+			}
+		/**
+		 * Counts a passed assertion : the fast path of all assertions
+		 * @param name the name of the assertion
+		*/
+			void passes(Name name){
+				passed++;
+				print_result(name,true);
+			}
+		/**
+		 * Counts a failed assertion and outputs a message.
+		 * Failures are rare : the message is only formatted here.
+		 * @param name the name of the assertion
+		 * @param message the message (a line, without end of line), may be empty
+		*/
+			TESTS_NOINLINE TESTS_INLINE void fails(Name name, const char* message);
+		/**
+		 * Counts a failed assertion and outputs the expected and computed values
+		*/
+			TESTS_NOINLINE TESTS_INLINE void fails(Name name, Value expected, Value computed);
+		/**
+		 * Assert a value is true
+		 * @param value the value who must be true
+		 * @param name the name of the test (not mandatory)
+		*/
+			void assert_true(bool value, Name name="")
+			{
+				if(value) passes(name);
+				else fails(name,value_of(true),value_of(false));
+			}
+		/**
+		 * Assert a value is false
+		 * @param value the value who must be false
+		 * @param name the name of the test (not mandatory)
+		*/
+			void assert_false(bool value, Name name="")
+			{
+				if(!value) passes(name);
+				else fails(name,value_of(false),value_of(true));
+			}
+		/**
+		 * Failed the test
+		 *  @param name the name of the test (not mandatory)
+		*/
+			void fail(Name name="")
+			{
+				fails(name,"");
+			}
+		/**
+		 * Pass the test
+		 *  @param name the name of the test (not mandatory)
+		*/
+			void pass(Name name="")
+			{
+				passes(name);
+			}
+		/**
+		 * Asserts two values are equal
+		 * @param expected the value expected
+		 * @param value the value computed by the test
+		 * @param name the name of the test (not mandatory)
+		 * @tparam T the type of values
+		*/
+			template <typename T>
+			void assert_equal(const T& expected, const T& value,Name name=""){
+				// special case for nan
+				if(expected==value || (is_nan(expected) && is_nan(value)))
+					passes(name);
+				else fails(name,value_of(expected),value_of(value));
+			}
+		/**
+		 * Asserts two float values are equal
+		 * @param expected the value expected
+		 * @param value the value computed by the test
+		 * @param precision the precision of the test
+		 * @param name the name of the test (not mandatory)
+		*/
+			void assert_equal(const double& expected, const double& value, double precision, Name name=""){
+				if((expected>value ? expected-value : value-expected)<precision) passes(name);
+				else fails(name,value_of(expected),value_of(value));
+			}
+
+		/**
+		 * Asserts two values are not equal
+		 * @param not_expected the value expected to be different
+		 * @param value the value computed by the test
+		 * @param name the name of the test (not mandatory)
+		 * @tparam T the type of values
+		*/
+			template <typename T>
+			void assert_not_equal(const T& not_expected, const T& value, Name name=""){
+				if(not_expected!=value) passes(name);
+				else fails(name,"");
+			}
+		/**
+		 * Asserts two float values are not equal
+		 * @param not_expected the value expected
+		 * @param value the value computed by the test
+		 * @param precision the precision of the test
+		 * @param name the name of the test (not mandatory)
+		*/
+			void assert_not_equal(const double& not_expected, const double& value, double precision, Name name=""){
+				if((not_expected>value ? not_expected-value : value-not_expected) > precision) passes(name);
+				else fails(name,"");
+			}
+		/**
+		 * Assert an expression throws an exception
+		 * @param testing a functionnal object (ie lambda expression) with code who can throw except
+		 * @param name the name of the test (not mandatory)
+		 * @tparam except the exception type
+		 * @tparam function the functionnal type
+		*/
+			template <typename except, typename function> void assert_throws( function testing, Name name="")
+			{
+				try
+				{
+					testing();
+				}
+				catch(const except&)
+				{
+					passes(name);
+					return;
+				}
+				catch(const Timeout&)
+				{
+					throw;
+				}
+				catch(...)
+				{
+					fails(name,"another exception is thrown");
+					return;
+				}
+				fails(name,"no exception is thrown");
+			}
+		/**
+		 * Asserts a code does not allocate on the heap : assert_no_alloc([&](){ parser.parse(line); }, "parse")
+		 * The allocations of the thread running the test are counted, when the program defines TESTS_COUNT_ALLOCATIONS
+		 * (the assertion fails otherwise).
+		 * @param code a functionnal object (ie lambda expression) with the checked code
+		 * @param name the name of the test (not mandatory)
+		 * @tparam function the functionnal type
+		*/
+			template <typename function>
+			void assert_no_alloc(function code, Name name=""){
+				assert_max_allocations(0, code, name);
+			}
+		/**
+		 * Asserts a code allocates at most a number of times on the heap (see assert_no_alloc)
+		 * @param max the maximum number of allocations
+		 * @param code a functionnal object (ie lambda expression) with the checked code
+		 * @param name the name of the test (not mandatory)
+		 * @tparam function the functionnal type
+		*/
+			template <typename function>
+			void assert_max_allocations(std::uint64_t max, function code, Name name=""){
+				AllocationCounters& counters = allocation_counters();
+				std::uint64_t count = counters.count, bytes = counters.bytes;
+				code();
+				count = counters.count-count;
+				bytes = counters.bytes-bytes;
+				if(count<=max && allocations_counted()) passes(name);
+				else memory_failed(name, count, bytes, max, false);
+			}
+		/**
+		 * Asserts the memory allocated by a code, and not freed yet, stays below a number of bytes (see assert_no_alloc)
+		 * @param limit the limit, in bytes
+		 * @param code a functionnal object (ie lambda expression) with the checked code
+		 * @param name the name of the test (not mandatory)
+		 * @tparam function the functionnal type
+		*/
+			template <typename function>
+			void assert_peak_memory_below(std::uint64_t limit, function code, Name name=""){
+				AllocationCounters& counters = allocation_counters();
+				std::int64_t live = counters.live, peak = counters.peak;
+				counters.peak = live;
+				code();
+				std::uint64_t used = (std::uint64_t)(counters.peak-live);
+				if(peak>counters.peak) counters.peak = peak;
+				if(used<limit && allocations_counted()) passes(name);
+				else memory_failed(name, used, 0, limit, true);
+			}
+		/**
+		 * Asserts a code is fast enough : it is repeated by batches which last at least 1 ms, and the median
+		 * time of a call over the batches (up to 21 of them, or 1 s) must not exceed the budget.
+		 * The compiler must not optimize the code away (see do_not_optimize).
+		 * With a store of baselines (see set_baseline), it also fails when it is significantly slower than its baseline.
+		 * @param budget the maximum time of a call, in nanoseconds
+		 * @param code a functionnal object (ie lambda expression) with the measured code
+		 * @param name the name of the test (not mandatory)
+		 * @tparam function the functionnal type
+		*/
+			template <typename function>
+			void assert_faster_than(double budget, function code, Name name=""){
+				Timed timed = { &code, &run_calls<function> };
+				check_time(budget, timed, name);
+			}
+		/**
+		 * Asserts the complexity of a code is not worse than expected :
+		 * assert_complexity(tests::O_n_log_n, [](std::size_t n){ return random_vector(n); }, [](std::vector<int>& v){ std::sort(v.begin(), v.end()); })
+		 * The code runs on inputs of growing sizes (see set_complexity_sizes), built by the generator out of the measure.
+		 * A call which lasts less than 1 us on the smallest input is repeated on one input kept in the cache : its result
+		 * must not change the work of the next calls. Slower code runs once on each of distinct inputs.
+		 * The sizes are measured in 5 rounds, and their fastest times are fitted to each complexity class : the simplest
+		 * class which fits them about as well as the best one must not be worse than the expected one.
+		 * When even the best fit has a relative error above 0.2, the times tell no class : the assertion fails and
+		 * reports that its result is inconclusive.
+		 * @param expected the expected complexity
+		 * @param make the generator of the inputs, called with their size
+		 * @param code a functionnal object (ie lambda expression) called with a reference on an input
+		 * @param name the name of the test (not mandatory)
+		 * @tparam generator the functionnal type of the generator
+		 * @tparam function the functionnal type of the code
+		*/
+			template <typename generator, typename function>
+			void assert_complexity(Complexity expected, generator make, function code, Name name=""){
+				ScaledCode<generator, function> context = { make, code };
+				Scaled scaled = { &context, &ScaledCode<generator, function>::prepare, &ScaledCode<generator, function>::run,
+					&ScaledCode<generator, function>::release };
+				check_complexity(expected, scaled, name);
+			}
+		/**
+		 * Runs a code on several threads at once, to find races and to measure how it scales :
+		 * stress(8, 100000, [&](unsigned thread, std::uint64_t i){ queue.push(i); tests::stress_point(); queue.pop(); })
+		 * The threads are released together by a spin barrier, then each one calls the code for its iterations :
+		 * it is a round (see set_stress_rounds). The stress is run again for 1, 2, 4... threads, up to the given number,
+		 * and the throughput of each number of threads (the calls each thread has run, over its time) is shown with the result. Calls of tests::stress_point in
+		 * the code are perturbed by yields and short spins, drawn from a seed shown when the stress fails.
+		 * The code must not call assertions : the stress fails when it throws.
+		 * @param threads the maximum number of threads (0 : the number of cores)
+		 * @param iterations the number of calls of the code by each thread, in each round
+		 * @param code a functionnal object (ie lambda expression) called with the number of its thread and of the iteration
+		 * @param name the name of the test (not mandatory)
+		 * @tparam function the functionnal type of the code
+		*/
+			template <typename function>
+			void stress(unsigned threads, std::uint64_t iterations, function code, Name name=""){
+				Stressed stressed = { &code, &run_stressed<function>, nullptr, nullptr };
+				check_stress(threads, iterations, stressed, name);
+			}
+		/**
+		 * Runs a code on several threads at once, and checks an invariant after each round (see stress)
+		 * @param threads the maximum number of threads (0 : the number of cores)
+		 * @param iterations the number of calls of the code by each thread, in each round
+		 * @param code a functionnal object (ie lambda expression) called with the number of its thread and of the iteration
+		 * @param check a functionnal object which returns true when the invariant holds, called while no thread runs
+		 * @param name the name of the test (not mandatory)
+		 * @tparam function the functionnal type of the code
+		 * @tparam invariant the functionnal type of the invariant
+		*/
+			template <typename function, typename invariant, typename = typename std::enable_if<!std::is_convertible<invariant, Name>::value>::type>
+			void stress(unsigned threads, std::uint64_t iterations, function code, invariant check, Name name=""){
+				Stressed stressed = { &code, &run_stressed<function>, &check, &invariant_holds<invariant> };
+				check_stress(threads, iterations, stressed, name);
+			}
+		/**
+		 * Asserts an output is the same as its snapshot (see set_snapshots and SnapshotStore) :
+		 * assert_snapshot([&](std::ostream& output){ report.render(output); }, "report")
+		 * The output is hashed while it is written, so it is never held in memory : only its hash and its size
+		 * are compared with the snapshot. In update mode, the output becomes the snapshot. When it differs, the
+		 * producer is called again to write the output to a file, for diffing : it must write the same output each time.
+		 * @param produce a functionnal object (ie lambda expression) which writes the output to the stream it receives
+		 * @param name the name of the snapshot, unique in the test
+		 * @tparam function the functionnal type : only callable types match, other outputs (as C strings) are std::string
+		*/
+			template <typename function>
+			auto assert_snapshot(function produce, Name name) -> decltype(produce(std::declval<std::ostream&>()), void()){
+				check_snapshot(name, &produce, &produce_output<function>);
+			}
+		/**
+		 * Asserts an output is the same as its snapshot
+		 * @param output the output
+		 * @param name the name of the snapshot, unique in the test
+		*/
+			TESTS_INLINE void assert_snapshot(const std::string& output, Name name);
+		/**
+		 * Checks a property for many random arguments, drawn by default generators (see tests::gen) :
+		 * for_all<gen::integer<int>, gen::string>([](int n, const std::string& s){ return ...; }, "name")
+		 * The property returns true when it holds. The cases are checked by batches on several threads
+		 * (see set_property_threads), so it must not call assertions.
+		 * When it returns false or throws, its arguments are shrunk to a minimal counterexample, which is shown
+		 * with the seed to replay it (see set_property_seed). The property counts as one assertion.
+		 * @param p the property
+		 * @param name the name of the test (not mandatory)
+		 * @tparam generators the generators of the arguments
+		 * @tparam property the functionnal type of the property
+		*/
+			template <typename... generators, typename property>
+			void for_all(const property& p, Name name=""){
+				check_property(std::tuple<generators...>(), p, name);
+			}
+		/**
+		 * Checks a property for many random arguments, drawn by given generators :
+		 * for_all(std::make_tuple(gen::integer<int>(1,100), gen::string(8)), [](int n, const std::string& s){ return ...; })
+		 * @param with the generators of the arguments
+		 * @param p the property
+		 * @param name the name of the test (not mandatory)
+		 * @tparam generators the generators of the arguments
+		 * @tparam property the functionnal type of the property
+		*/
+			template <typename... generators, typename property>
+			void for_all(const std::tuple<generators...>& with, const property& p, Name name=""){
+				check_property(with, p, name);
+			}
+		/**
+		 * Checks each record of a CSV file, which is mapped in memory and parsed without copy :
+		 * for_each_csv<int, double, tests::Text>("golden.csv", [](int id, double value, const tests::Text& label){ return ...; })
+		 * Each line is a record of comma separated fields (spaces around them, and double quotes, are removed), converted
+		 * to the types of the fields : integers, floating numbers, char, std::string or tests::Text (a view into the file).
+		 * A field in double quotes may contain commas, and doubled quotes which are kept as they are : it can't span lines.
+		 * Empty lines and lines which start with '#' are ignored.
+		 * The hook returns true when the record is right. The file is split in chunks checked on several threads
+		 * (see set_data_threads), so it must not call assertions. The pages checked are released, so the memory
+		 * does not grow with the size of the file. The file counts as one assertion, which fails on the first
+		 * wrong record (or the first one which can't be parsed).
+		 * @param path the path of the file
+		 * @param h the hook
+		 * @param name the name of the test (not mandatory)
+		 * @param header true if the first line is a header to skip
+		 * @tparam fields the types of the fields
+		 * @tparam hook the functionnal type of the hook
+		*/
+			template <typename... fields, typename hook>
+			void for_each_csv(const std::string& path, const hook& h, Name name="", bool header=false){
+				check_csv<hook, fields...>(path, h, name, header);
+			}
+		/**
+		 * Checks each record of a binary file, which is mapped in memory : the records follow each other, and each
+		 * one is the sequence of its fields, without padding, in the byte order of the machine.
+		 * for_each_binary<std::uint32_t, double>("golden.bin", [](std::uint32_t id, double value){ return ...; })
+		 * The fields must be trivially copyable. As for_each_csv, the file is checked by chunks on several threads.
+		 * @param path the path of the file
+		 * @param h the hook
+		 * @param name the name of the test (not mandatory)
+		 * @tparam fields the types of the fields
+		 * @tparam hook the functionnal type of the hook
+		*/
+			template <typename... fields, typename hook>
+			void for_each_binary(const std::string& path, const hook& h, Name name=""){
+				check_binary<hook, fields...>(path, h, name);
+			}
+
+		/**
+		 * Asserts a collection contains a value
+		 * @param begin the first element of collection
+		 * @param end the invalid element of collection (after last)
+		 * @param value the value to find
+		 * @param name the name of the test (not mandatory)
+		 * @tparam iterator the type of iterator
+		 * @tparam T the type of the value
+		*/
+			template <typename iterator, typename T>
+			void assert_contains(iterator begin, iterator end, const T& value, Name name="")
+			{
+				if(find_value(begin,end,value)!=end) passes(name);
+				else fails(name,"element not founded");
+			}
+		/**
+		 * Asserts a collection not contains a value
+		 * @param begin the first element of collection
+		 * @param end the invalid element of collection (after last)
+		 * @param value the value to find
+		 * @param name the name of the test (not mandatory)
+		 * @tparam iterator the type of iterator
+		 * @tparam T the type of the value
+		*/
+			template <typename iterator, typename T>
+			void assert_not_contains(iterator begin, iterator end, const T& value, Name name="")
+			{
+				if(find_value(begin,end,value)==end) passes(name);
+				else fails(name,"element founded");
+			}
+		/**
+		 * Asserts a container contains a value, with the find function of the container when it has one
+		 * (std::set, std::unordered_set, std::map...), or a linear search
+		 * @param values the container
+		 * @param value the value to find
+		 * @param name the name of the test (not mandatory)
+		 * @tparam container the type of the container
+		 * @tparam T the type of the value
+		*/
+			template <typename container, typename T>
+			typename std::enable_if<is_container<container>::value>::type assert_contains(const container& values, const T& value, Name name="")
+			{
+				if(contains(values,value)) passes(name);
+				else fails(name,"element not founded");
+			}
+		/**
+		 * Asserts a container not contains a value, with the find function of the container when it has one
+		 * @param values the container
+		 * @param value the value to find
+		 * @param name the name of the test (not mandatory)
+		 * @tparam container the type of the container
+		 * @tparam T the type of the value
+		*/
+			template <typename container, typename T>
+			typename std::enable_if<is_container<container>::value>::type assert_not_contains(const container& values, const T& value, Name name="")
+			{
+				if(!contains(values,value)) passes(name);
+				else fails(name,"element founded");
+			}
+		/**
+		 * Asserts a sorted collection contains a value, with a binary search : assert_contains(tests::sorted_range, begin, end, value)
+		 * @param begin the first element of collection
+		 * @param end the invalid element of collection (after last)
+		 * @param value the value to find
+		 * @param name the name of the test (not mandatory)
+		 * @tparam iterator the type of iterator
+		 * @tparam T the type of the value
+		*/
+			template <typename iterator, typename T>
+			void assert_contains(SortedRange, iterator begin, iterator end, const T& value, Name name="")
+			{
+				if(sorted_contains(begin,end,value)) passes(name);
+				else fails(name,"element not founded");
+			}
+		/**
+		 * Asserts a sorted collection not contains a value, with a binary search
+		 * @param begin the first element of collection
+		 * @param end the invalid element of collection (after last)
+		 * @param value the value to find
+		 * @param name the name of the test (not mandatory)
+		 * @tparam iterator the type of iterator
+		 * @tparam T the type of the value
+		*/
+			template <typename iterator, typename T>
+			void assert_not_contains(SortedRange, iterator begin, iterator end, const T& value, Name name="")
+			{
+				if(!sorted_contains(begin,end,value)) passes(name);
+				else fails(name,"element founded");
+			}
+		/**
+		 * Asserts a collection contains all the values of another one. The collection is indexed once
+		 * (hash set, or sorted array), so checking m values in n elements costs O(n+m).
+		 * Every missing value is shown.
+		 * @param first the first element of the collection
+		 * @param last the invalid element of the collection (after last)
+		 * @param first_value the first value to find
+		 * @param last_value the invalid value to find (after last)
+		 * @param name the name of the test (not mandatory)
+		 * @tparam iter1 the type of iterator of the collection (a forward iterator)
+		 * @tparam iter2 the type of iterator of the values
+		*/
+			template <typename iter1, typename iter2>
+			void assert_contains_all(iter1 first, iter1 last, iter2 first_value, iter2 last_value, Name name="");
+		/**
+		 * Asserts a collection contains none of the values of another one, in O(n+m). Every value found is shown.
+		 * @param first the first element of the collection
+		 * @param last the invalid element of the collection (after last)
+		 * @param first_value the first value to find
+		 * @param last_value the invalid value to find (after last)
+		 * @param name the name of the test (not mandatory)
+		 * @tparam iter1 the type of iterator of the collection (a forward iterator)
+		 * @tparam iter2 the type of iterator of the values
+		*/
+			template <typename iter1, typename iter2>
+			void assert_contains_none(iter1 first, iter1 last, iter2 first_value, iter2 last_value, Name name="");
+		/**
+		 * Asserts a container contains all the values of another container, with the find function of the
+		 * container when it has one, or an index built once
+		 * @param values the container
+		 * @param wanted the values to find
+		 * @param name the name of the test (not mandatory)
+		*/
+			template <typename container1, typename container2>
+			void assert_contains_all(const container1& values, const container2& wanted, Name name="")
+			{
+				check_membership(values, wanted, true, name, std::integral_constant<bool, has_find<container1, typename container2::value_type>::value>());
+			}
+		/**
+		 * Asserts a container contains none of the values of another container
+		 * @param values the container
+		 * @param unwanted the values which must not be found
+		 * @param name the name of the test (not mandatory)
+		*/
+			template <typename container1, typename container2>
+			void assert_contains_none(const container1& values, const container2& unwanted, Name name="")
+			{
+				check_membership(values, unwanted, false, name, std::integral_constant<bool, has_find<container1, typename container2::value_type>::value>());
+			}
+		/**
+		 * Asserts two collections are identical (same elements in same order)
+		 * collections may be differents (list and vector) but elements type must be identical
+		 * Contiguous collections of integers, characters or pointers (arrays, std::vector, std::string) are compared
+		 * as raw memory, with vector instructions. When the collections differ, the index of the first difference,
+		 * the number of differences and the elements around the first one are shown.
+		 * @tparam iter1 type of iterator of the first collection (an input iterator)
+		 * @tparam iter2 type of iterator of the second collection (an input iterator)
+		 * @param first1 begin of the first collection
+		 * @param last1 end of the first collection
+		 * @param first2 begin of the second collection
+		 * @param last2 end of the second collection
+		 * @param name the name of the test (not mandatory)
+		*/
+			template <typename iter1, typename iter2>
+			void assert_collection_equals(iter1 first1, iter1 last1, iter2 first2, iter2 last2,Name name="")
+			{
+				typedef typename std::remove_cv<typename std::iterator_traits<iter1>::value_type>::type value1;
+				typedef typename std::remove_cv<typename std::iterator_traits<iter2>::value_type>::type value2;
+				compare_collections(first1, last1, first2, last2, name, std::integral_constant<bool,
+					is_contiguous_iterator<iter1>::value && is_contiguous_iterator<iter2>::value
+					&& std::is_same<value1,value2>::value && is_bytewise_comparable<value1>::value>());
+			}
+
+		/**
+		 * Asserts a pointer is null
+		 * @tparam T type of pointer
+		 * @param pointer the pointer to test
+		 * @param name name of the test (not mandatory)
+		*/
+			template <typename T>
+			void assert_null(const T* pointer,Name name="")
+			{
+				if(pointer==nullptr) passes(name);
+				else fails(name,"pointer is not null !");
+			}
+		/**
+		 * Asserts a pointer is not null
+		 * @tparam T type of pointer
+		 * @param pointer the pointer to test
+		 * @param name name of the test (not mandatory)
+		*/
+			template <typename T>
+			void assert_not_null(const T* pointer, Name name=""){
+				if(pointer!=nullptr) passes(name);
+				else fails(name,"pointer is null !");
+			}
+
+		/**
+		 * Asserts two values have the same type. It is decided at compile time (see same_type),
+		 * but for polymorphic values when RTTI is enabled.
+		 * @tparam T1 the type of value 1
+		 * @tparam T2 the type of value 2
+		 * @param value1 the first value
+		 * @param value2 the second value
+		 * @param name name of the test (not mandatory)
+		*/
+			template <typename T1, typename T2>
+			void assert_same_type(const T1& value1, const T2& value2, Name name=""){
+				if(same_type(value1,value2)) passes(name);
+				else fails(name,"not the same type !");
+			}
+
+		/**
+		 * Asserts two values have differents types
+		 * @tparam T1 the type of value 1
+		 * @tparam T2 the type of value 2
+		 * @param value1 the first value
+		 * @param value2 the second value
+		 * @param name name of the test (not mandatory)
+		*/
+			template <typename T1, typename T2>
+			void assert_not_same_type(const T1& value1, const T2& value2, Name name=""){
+				if(!same_type(value1,value2)) passes(name);
+				else fails(name,"the same type !");
+			}
+
+		/**
+		 * Checks a condition at compile time : static_test<(Ratio(1,2)+Ratio(1,2)==Ratio(1))>("add")
+		 * A false condition stops the compilation at the line of the call. Nothing is checked at run time :
+		 * the test is only counted as a passed assertion, and the number of compile-time tests is shown in the resume.
+		 * @param name name of the test (not mandatory)
+		 * @tparam condition the condition, a constant expression
+		*/
+			template <bool condition>
+			void static_test(Name name=""){
+				static_assert(condition, "static_test failed (see the line which requires it)");
+				static_passed++;
+				passes(name);
+			}
+		/**
+		 * Asserts at compile time that two types are the same (std::is_same), without RTTI
+		 * @tparam T1 the first type
+		 * @tparam T2 the second type
+		 * @param name name of the test (not mandatory)
+		*/
+			template <typename T1, typename T2>
+			void static_same_type(Name name=""){
+				static_test<std::is_same<T1,T2>::value>(name);
+			}
+		/**
+		 * Asserts at compile time that two types are different (std::is_same), without RTTI
+		 * @tparam T1 the first type
+		 * @tparam T2 the second type
+		 * @param name name of the test (not mandatory)
+		*/
+			template <typename T1, typename T2>
+			void static_not_same_type(Name name=""){
+				static_test<!std::is_same<T1,T2>::value>(name);
+			}
+	};
+
+// assertions on common types, instantiated once by test.cpp
+#define TESTS_COMMON_VALUES(X, prefix) X(prefix, bool) X(prefix, char) X(prefix, int) X(prefix, unsigned) X(prefix, long) \
+	X(prefix, unsigned long) X(prefix, long long) X(prefix, unsigned long long) X(prefix, float) X(prefix, double) X(prefix, std::string)
+#define TESTS_COMMON_COLLECTIONS(X, prefix) X(prefix, std::vector<int>::const_iterator) X(prefix, std::vector<int>::iterator) \
+	X(prefix, std::vector<double>::const_iterator) X(prefix, std::vector<double>::iterator) \
+	X(prefix, std::vector<std::string>::const_iterator) X(prefix, std::vector<std::string>::iterator) \
+	X(prefix, std::string::const_iterator) X(prefix, std::string::iterator) X(prefix, const int*) X(prefix, const char*)
+#define TESTS_VALUE_INSTANTIATION(prefix, T) \
+	prefix template void print_value<T>(std::ostream&, const void*); \
+	prefix template void Test::assert_equal<T>(const T&, const T&, Name); \
+	prefix template void Test::assert_not_equal<T>(const T&, const T&, Name);
+#define TESTS_COLLECTION_INSTANTIATION(prefix, I) \
+	prefix template void Test::assert_collection_equals<I, I>(I, I, I, I, Name);
+#if defined(TESTS_SEPARATE_COMPILATION) && !defined(TESTS_IMPLEMENTATION)
+	TESTS_COMMON_VALUES(TESTS_VALUE_INSTANTIATION, extern)
+	TESTS_COMMON_COLLECTIONS(TESTS_COLLECTION_INSTANTIATION, extern)
+#endif
+}
+
+#endif
@@ -36,7 +36,15 @@ int main()
 
     std::cout << "Test bad one "<<std::endl;
     bad_test test2;
+#if defined(__unix__) || defined(__APPLE__)
+    // the loop never reaches an assertion : only an isolated worker process can be stopped
+    tests::Suite suite;
+    suite.set_isolated(true);
+    suite.add(test2);
+    suite.run();
+#else
     test2.run(); 
+#endif
 
     return 0;
 }
\ No newline at end of file
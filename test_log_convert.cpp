@@ -0,0 +1,343 @@
+/**
+ * Converts a binary log written by tests::BinaryReporter
+ * usage : test_log_convert <junit|jsonl|summary> <log file>
+ * The log is read by memory mapping (on POSIX systems) and streamed to the standard output.
+*/
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <cstdio>
+#include <cstring>
+#include "test.h"
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/stat.h>
+#endif
+
+typedef tests::BinaryReporter Log;
+
+/**
+ * A log in memory (mapped, or read when mapping is not available)
+*/
+class LogFile
+{
+    const char* data;
+    std::size_t length;
+    std::vector<char> copy;
+ public:
+    explicit LogFile(const char* path) : data(nullptr), length(0){
+#if defined(__unix__) || defined(__APPLE__)
+        int fd = open(path, O_RDONLY);
+        struct stat info;
+        if(fd>=0 && fstat(fd,&info)==0 && info.st_size>0){
+            void* memory = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if(memory!=MAP_FAILED){
+                data = static_cast<const char*>(memory);
+                length = info.st_size;
+                madvise(memory, length, MADV_SEQUENTIAL);
+            }
+        }
+        if(fd>=0) close(fd);
+        if(data!=nullptr) return;
+#endif
+        std::ifstream file(path, std::ios::binary);
+        copy.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+        data = copy.data();
+        length = copy.size();
+    }
+    ~LogFile(){
+#if defined(__unix__) || defined(__APPLE__)
+        if(copy.empty() && data!=nullptr) munmap(const_cast<char*>(data), length);
+#endif
+    }
+    const char* begin() const {return data;}
+    const char* end() const {return data+length;}
+};
+
+/**
+ * Reads the records of a log. A value cut by the end of the log makes it truncated.
+*/
+class Reader
+{
+    const char* position;
+    const char* last;
+    bool cut;
+ public:
+    Reader(const char* first, const char* last):position(first),last(last),cut(false){}
+    bool done() const {return position>=last;}
+    bool truncated() const {return cut;}
+    const char* where() const {return position;}
+    unsigned char tag(){
+        return (unsigned char)*position++;
+    }
+    unsigned long long varint(){
+        unsigned long long value=0;
+        int shift=0;
+        for(;;){
+            if(position>=last || shift>63){
+                cut = true;
+                return value;
+            }
+            unsigned char byte = (unsigned char)*position++;
+            value |= (unsigned long long)(byte&0x7f)<<shift;
+            if((byte&0x80)==0) return value;
+            shift+=7;
+        }
+    }
+    std::string text(){
+        std::size_t size = (std::size_t)varint();
+        if(size>(std::size_t)(last-position)){
+            size = last-position;
+            cut = true;
+        }
+        std::string result(position, size);
+        position += size;
+        return result;
+    }
+};
+
+/**
+ * One result, as decoded from the log
+*/
+struct Event
+{
+    unsigned char tag;
+    std::string test; // name of the current test
+    std::string name; // name of the assertion, or text of the message
+    unsigned long long ns; // duration of the assertion or of the test
+    unsigned long long passed;
+    unsigned long long failed;
+};
+
+/**
+ * Decodes a log and calls the handler for each begin, assertion, message and end of test.
+ * A corrupt or truncated log is decoded up to its first bad record.
+*/
+template <typename handler>
+bool decode(const LogFile& log, handler handle)
+{
+    if(log.end()-log.begin()<8 || std::memcmp(log.begin(), Log::magic(), 8)!=0){
+        std::cerr << "not a test log" << std::endl;
+        return false;
+    }
+    Reader reader(log.begin()+8, log.end());
+    std::vector<std::string> names;
+    Event event;
+    const char* record;
+    auto corrupt = [&](){
+        std::cerr << "corrupt log at offset " << (record-log.begin()) << std::endl;
+        return false;
+    };
+    // a name must be interned by a string record before it is used
+    auto name = [&](std::string& result){
+        unsigned long long id = reader.varint();
+        if(id>=names.size()) return false;
+        result = names[(std::size_t)id];
+        return true;
+    };
+    while(!reader.done()){
+        record = reader.where();
+        event.tag = reader.tag();
+        switch(event.tag){
+            case Log::session:
+                reader.varint();
+                names.clear();
+                break;
+            case Log::string: {
+                // ids are given in order : a new one is the next one
+                unsigned long long id = reader.varint();
+                if(id>names.size()) return corrupt();
+                if(id==names.size()) names.emplace_back();
+                names[(std::size_t)id] = reader.text();
+                break;
+            }
+            case Log::begin:
+                if(!name(event.test) || reader.truncated()) return corrupt();
+                handle(event);
+                break;
+            case Log::pass:
+            case Log::fail:
+                if(!name(event.name)) return corrupt();
+                event.ns = reader.varint();
+                if(reader.truncated()) return corrupt();
+                handle(event);
+                break;
+            case Log::text:
+                event.name = reader.text();
+                if(reader.truncated()) return corrupt();
+                handle(event);
+                break;
+            case Log::end:
+                event.passed = reader.varint();
+                event.failed = reader.varint();
+                event.ns = reader.varint();
+                if(reader.truncated()) return corrupt();
+                handle(event);
+                break;
+            default:
+                return corrupt();
+        }
+        if(reader.truncated()) return corrupt();
+    }
+    return true;
+}
+
+std::string escape_xml(const std::string& text)
+{
+    std::string result;
+    for(char c : text){
+        switch(c){
+            case '<': result += "&lt;"; break;
+            case '>': result += "&gt;"; break;
+            case '&': result += "&amp;"; break;
+            case '"': result += "&quot;"; break;
+            // kept in attributes, which parsers would normalize into spaces
+            case '\n': result += "&#10;"; break;
+            case '\r': result += "&#13;"; break;
+            case '\t': result += "&#9;"; break;
+            default:
+                // other control characters are not allowed by XML 1.0, even as references
+                if((unsigned char)c<0x20){
+                    char code[8];
+                    std::snprintf(code, sizeof(code), "\\u%04x", c);
+                    result += code;
+                }
+                else result += c;
+        }
+    }
+    return result;
+}
+
+std::string escape_json(const std::string& text)
+{
+    std::string result;
+    for(char c : text){
+        switch(c){
+            case '"': result += "\\\""; break;
+            case '\\': result += "\\\\"; break;
+            case '\n': result += "\\n"; break;
+            case '\r': result += "\\r"; break;
+            case '\t': result += "\\t"; break;
+            default:
+                if((unsigned char)c<0x20){
+                    char code[8];
+                    std::snprintf(code, sizeof(code), "\\u%04x", c);
+                    result += code;
+                }
+                else result += c;
+        }
+    }
+    return result;
+}
+
+/**
+ * JUnit XML : a testsuite for each test, a testcase for each assertion
+*/
+bool junit(const LogFile& log)
+{
+    std::cout << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<testsuites>\n";
+    bool failure_open=false;
+    std::vector<std::string> messages;
+    // the counters of a test are in its end record : the suite is written when the test ends, cases are buffered
+    std::string cases;
+    auto close_case = [&](){
+        if(!failure_open) return;
+        std::string message;
+        for(auto& line : messages) message += (message.empty()?"":"\n")+line;
+        cases += "><failure message=\""+escape_xml(message)+"\"/></testcase>\n";
+        messages.clear();
+        failure_open=false;
+    };
+    bool ok = decode(log, [&](const Event& event){
+        switch(event.tag){
+            case Log::begin:
+                cases.clear();
+                break;
+            case Log::pass:
+            case Log::fail:
+                close_case();
+                cases += "    <testcase classname=\""+escape_xml(event.test)+"\" name=\""+escape_xml(event.name)
+                    +"\" time=\""+std::to_string(event.ns/1e9)+"\"";
+                if(event.tag==Log::pass) cases += "/>\n";
+                else failure_open=true;
+                break;
+            case Log::text:
+                if(failure_open) messages.push_back(event.name);
+                break;
+            case Log::end:
+                close_case();
+                std::cout << "  <testsuite name=\"" << escape_xml(event.test) << "\" tests=\"" << event.passed+event.failed
+                    << "\" failures=\"" << event.failed << "\" time=\"" << event.ns/1e9 << "\">\n" << cases << "  </testsuite>\n";
+                cases.clear();
+                break;
+        }
+    });
+    std::cout << "</testsuites>\n";
+    return ok;
+}
+
+/**
+ * JSON Lines : an object for each assertion, message and end of test
+*/
+bool jsonl(const LogFile& log)
+{
+    return decode(log, [](const Event& event){
+        std::string test = escape_json(event.test);
+        switch(event.tag){
+            case Log::pass:
+            case Log::fail:
+                std::cout << "{\"type\":\"assertion\",\"test\":\"" << test << "\",\"name\":\"" << escape_json(event.name)
+                    << "\",\"passed\":" << (event.tag==Log::pass?"true":"false") << ",\"ns\":" << event.ns << "}\n";
+                break;
+            case Log::text:
+                std::cout << "{\"type\":\"message\",\"test\":\"" << test << "\",\"text\":\"" << escape_json(event.name) << "\"}\n";
+                break;
+            case Log::end:
+                std::cout << "{\"type\":\"test\",\"test\":\"" << test << "\",\"passed\":" << event.passed
+                    << ",\"failed\":" << event.failed << ",\"ns\":" << event.ns << "}\n";
+                break;
+        }
+    });
+}
+
+/**
+ * Summary : a line for each test, then the totals
+*/
+bool summary(const LogFile& log)
+{
+    unsigned long long tests=0, tests_failed=0, passed=0, failed=0, ns=0;
+    bool ok = decode(log, [&](const Event& event){
+        if(event.tag!=Log::end) return;
+        std::cout << (event.failed>0?"FAILED ":"ok     ") << event.test << " : " << event.passed << " passed, "
+            << event.failed << " failed, " << event.ns/1e6 << " ms\n";
+        tests++;
+        if(event.failed>0) tests_failed++;
+        passed += event.passed;
+        failed += event.failed;
+        ns += event.ns;
+    });
+    std::cout << tests << " tests, " << tests_failed << " failed. Assertions : " << passed << " passed and "
+        << failed << " failed. Total test time is " << ns/1e6 << " ms.\n";
+    return ok;
+}
+
+int main(int argc, char** argv)
+{
+    if(argc!=3){
+        std::cerr << "usage : " << argv[0] << " <junit|jsonl|summary> <log file>" << std::endl;
+        return 2;
+    }
+    std::ios::sync_with_stdio(false);
+    LogFile log(argv[2]);
+    std::string format(argv[1]);
+    bool ok;
+    if(format=="junit") ok = junit(log);
+    else if(format=="jsonl") ok = jsonl(log);
+    else if(format=="summary") ok = summary(log);
+    else{
+        std::cerr << "unknown format " << format << std::endl;
+        return 2;
+    }
+    return ok ? 0 : 1;
+}